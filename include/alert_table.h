@@ -0,0 +1,62 @@
+// ==================== include/alert_table.h ====================
+#ifndef BOAT_PRO_ALERT_TABLE_H
+#define BOAT_PRO_ALERT_TABLE_H
+
+#include "types.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 实时告警表
+ * 保存最近一次跟踪检测后处于告警状态的全部告警。同一船只的同类告警在持续期间保持
+ * 相同的告警ID；每次更新与上次比较，输出新告警、等级升高、等级降低和告警解除
+ */
+class AlertTable {
+public:
+    const std::vector<CollisionAlert>& getAlerts() const { return alerts_; }
+
+    /**
+     * 用外部告警表替换(保留告警ID与等级)
+     */
+    void load(const std::vector<CollisionAlert>& alerts);
+
+    /**
+     * 以本次检测结果更新告警表并返回变化，为alerts中的告警分配ID
+     * alerts与告警表交换存储，两者的容量在各次检测间复用
+     */
+    std::vector<AlertDelta> update(std::vector<CollisionAlert>& alerts);
+
+    /**
+     * 生成避碰决策建议
+     * 建议只取决于告警等级及是否有前方/对向船只，返回预先驻留的常量字符串
+     */
+    static InternedString decisionAdvice(const CollisionAlert& alert);
+
+private:
+    /**
+     * 告警表中的告警：稳定ID及其在alerts_中的位置
+     */
+    struct TrackedAlert {
+        uint64_t alert_id;
+        size_t position;
+        uint64_t pass;  // 最近一次出现时的更新轮次
+    };
+
+    std::vector<CollisionAlert> alerts_;
+    std::unordered_map<uint64_t, TrackedAlert> tracked_;  // 告警键 -> 告警
+    std::vector<size_t> cleared_positions_;
+    uint64_t pass_ = 0;
+    uint64_t next_alert_id_ = 1;
+
+    /**
+     * 告警键(船只ID与告警类型)
+     */
+    static uint64_t alertKey(int boat_id, AlertType type);
+};
+
+} // namespace boat_pro
+
+#endif
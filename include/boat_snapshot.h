@@ -0,0 +1,115 @@
+// ==================== include/boat_snapshot.h ====================
+#ifndef BOAT_PRO_BOAT_SNAPSHOT_H
+#define BOAT_PRO_BOAT_SNAPSHOT_H
+
+#include "types.h"
+#include "local_projector.h"
+#include <map>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 船只状态快照(结构数组布局)
+ * 按船只ID升序连续存放各字段，位置投影到以origin为原点的局部东-北平面(米)，
+ * 速度分解为东向/北向分量(m/s)，供检测内循环顺序访问
+ */
+struct BoatSnapshot {
+    GeoPoint origin;                      // 局部平面原点
+    geometry::LocalProjector projector;  // 以origin为原点的切平面投影
+
+    std::vector<int> sysid;
+    std::vector<double> x;      // 东向坐标(米)
+    std::vector<double> y;      // 北向坐标(米)
+    std::vector<double> vx;     // 东向速度(m/s)
+    std::vector<double> vy;     // 北向速度(m/s)
+    std::vector<double> hx;     // 航向单位向量东向分量
+    std::vector<double> hy;     // 航向单位向量北向分量
+    std::vector<BoatStatus> status;
+    std::vector<RouteDirection> route_direction;
+
+    // 告警输出所需的原始字段
+    std::vector<double> lat;
+    std::vector<double> lng;
+    std::vector<double> heading;
+    std::vector<double> speed;
+
+    // 上报时刻及该时刻的位置，用于按线性运动外推
+    std::vector<double> timestamp;
+    std::vector<double> report_x;
+    std::vector<double> report_y;
+
+    /**
+     * 由船只状态表重建快照
+     * @param boats 按船只ID排序的状态表
+     * @param projection_origin 局部平面原点
+     */
+    void build(const std::map<int, BoatState>& boats, const GeoPoint& projection_origin);
+
+    /**
+     * 由按ID升序排列的紧凑记录重建快照
+     * 紧凑记录只是存储与传递格式，检测遍历读取重建后的结构数组
+     */
+    void build(const std::vector<PackedBoatState>& boats, const GeoPoint& projection_origin);
+
+    /**
+     * 在末尾追加一条船只(调用方负责保持ID升序)
+     */
+    void appendBoat(const BoatState& boat);
+
+    /**
+     * 用新的状态覆盖第i条船只
+     */
+    void setBoat(size_t i, const BoatState& boat);
+
+    void clear();
+
+    /**
+     * 清空并设置投影原点，为count条船只预留空间
+     */
+    void reset(const GeoPoint& projection_origin, size_t count);
+
+    size_t size() const { return sysid.size(); }
+    bool empty() const { return sysid.empty(); }
+
+    /**
+     * 指定船只ID的下标(二分查找)，不存在时返回size()
+     */
+    size_t indexOf(int boat_id) const;
+
+    /**
+     * 经纬度投影到局部平面(米)
+     */
+    void project(double latitude, double longitude, double& out_x, double& out_y) const {
+        projector.project(latitude, longitude, out_x, out_y);
+    }
+
+    /**
+     * 局部平面坐标(米)反投影为经纬度
+     */
+    GeoPoint unproject(double px, double py) const { return projector.unproject(px, py); }
+
+    /**
+     * 将所有船只位置(x, y)按各自速度从上报时刻线性外推到time时刻
+     */
+    void advanceTo(double time);
+
+    /**
+     * 恢复为上报时刻的位置
+     */
+    void restoreReportedPositions();
+
+    /**
+     * 所有船只中的最大速度(m/s)
+     */
+    double maxSpeed() const;
+
+    /**
+     * 所有船只到原点的最大坐标偏移(米)
+     */
+    double maxOffset() const;
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,81 @@
+// ==================== include/boat_state_store.h ====================
+#ifndef BOAT_PRO_BOAT_STATE_STORE_H
+#define BOAT_PRO_BOAT_STATE_STORE_H
+
+#include "types.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 已发布的船队状态(发布后不再修改)
+ */
+struct FleetSnapshot {
+    std::vector<PackedBoatState> boats;  // 紧凑记录，按船只ID升序
+    uint64_t version = 0;                // 每次发布递增
+
+    /**
+     * 按ID查找船只，不存在时返回nullptr
+     */
+    const PackedBoatState* find(int sysid) const { return findPackedBoat(boats, sysid); }
+};
+
+/**
+ * 船只状态发布存储(读-复制-更新)
+ * 写入方在私有副本上修改后原子替换已发布快照的指针；读取方原子获取
+ * 当前快照的共享指针，持有期间快照不会被修改或释放。
+ * 读取从不等待写入方复制状态表，也不会看到修改到一半的状态表。
+ * 单条更新先暂存，由flush()在每个检测周期合并一次后发布：每条消息O(1)，
+ * 每周期只复制一次状态表，而不是每条消息复制整表
+ */
+class BoatStateStore {
+public:
+    using SnapshotPtr = std::shared_ptr<const FleetSnapshot>;
+
+    BoatStateStore();
+
+    /**
+     * 暂存单条船只状态(新增或覆盖)，flush()后对读取方可见
+     */
+    void update(const BoatState& boat);
+
+    /**
+     * 一批船只状态与暂存的更新一起合并到当前船队并发布(同一ID保留最后一条)
+     */
+    void applyBatch(const std::vector<BoatState>& boats);
+
+    /**
+     * 整体替换船队状态并发布，丢弃尚未发布的暂存更新
+     */
+    void replace(const std::vector<BoatState>& boats);
+
+    /**
+     * 将暂存的更新一次归并到当前船队并发布；没有暂存更新时不发布新版本，返回false
+     */
+    bool flush();
+
+    /**
+     * 尚未发布的暂存更新条数
+     */
+    size_t pendingCount() const;
+
+    /**
+     * 获取当前已发布的快照
+     */
+    SnapshotPtr load() const;
+
+private:
+    SnapshotPtr published_;    // 只通过 std::atomic_load/std::atomic_store 访问
+    std::vector<PackedBoatState> pending_;  // 暂存的更新，按到达顺序
+    mutable std::mutex writer_mutex_;       // 写入方之间串行，读取方不加锁
+
+    void mergePending();
+    void publish(std::shared_ptr<FleetSnapshot> next);
+};
+
+} // namespace boat_pro
+
+#endif
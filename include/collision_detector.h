@@ -3,6 +3,19 @@
 #define BOAT_PRO_COLLISION_DETECTOR_H
 
 #include "types.h"
+#include "detection_types.h"
+#include "boat_snapshot.h"
+#include "spatial_hash_grid.h"
+#include "thread_pool.h"
+#include "route_index.h"
+#include "dock_corridor_index.h"
+#include "pair_cache.h"
+#include "recheck_schedule.h"
+#include "pair_priority_queue.h"
+#include "kinetic_tracker.h"
+#include "alert_table.h"
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <memory>
@@ -18,9 +31,21 @@ public:
     CollisionDetector(const SystemConfig& config);
     
     /**
-     * 更新船只状态数据
+     * 更新船只状态数据(整体替换当前船队)
+     * 只有状态发生变化的船只会被标记为待重算
      */
     void updateBoatStates(const std::vector<BoatState>& boats);
+    void updateBoatStates(const std::map<int, BoatState>& boats);
+    
+    /**
+     * 以紧凑记录整体替换当前船队(记录须按ID升序且不重复，如状态存储发布的快照)
+     */
+    void updateBoatStates(const std::vector<PackedBoatState>& boats);
+    
+    /**
+     * 更新单条船只状态(新增或覆盖)，并标记为待重算
+     */
+    void updateBoatState(const BoatState& boat);
     
     /**
      * 设置船坞信息
@@ -38,41 +63,470 @@ public:
      */
     std::vector<CollisionAlert> detectCollisions();
     
+    /**
+     * 检测所有碰撞风险，结果写入检测器内部复用的告警区，不复制告警列表
+     * 船队规模稳定后检测过程不分配堆内存(单线程检测)
+     * @return 告警区的引用，下次检测或更新告警表前有效
+     */
+    const std::vector<CollisionAlert>& detectCollisionsInPlace();
+    
+    /**
+     * 限时检测：按碰撞时间保守下界 (间距 - 安全距离) / (|v1| + |v2|) 从小到大求解候选船对，
+     * 时间预算用完时停止。下界不超过紧急阈值的船对无论预算如何都会求解，紧急告警不会遗漏：
+     * 船对枚举按船只区间分段进行，每段开始前检查时钟，预算用完后其余船只只枚举
+     * 紧急距离(2 * 最大船速 * 紧急阈值 + 安全距离)内的船对。
+     * 预算内覆盖全部船对时结果与detectCollisions()一致；否则getLastStats()中
+     * budget_exhausted为true，deferred_pairs为已枚举但未求解的船对数，covered_horizon_s为
+     * 保证完整检测的碰撞时间上限。枚举与求解在检测线程池上执行，不读写增量缓存
+     * @param budget 时间预算
+     */
+    std::vector<CollisionAlert> detectCollisions(std::chrono::steady_clock::duration budget);
+    
+    /**
+     * 动态(kinetic)检测：船只按各自时间戳以当前航速航向线性外推到now时刻
+     * 每个邻近船对保存一张证书(进入/离开碰撞半径的时刻)，证书在告警等级
+     * 可能变化的时刻进入事件队列；每次只处理到期事件和新状态涉及的船对，
+     * 稳定交通下的求解开销与事件数而非船对数成正比
+     * @param now 检测时刻(秒，与BoatState::timestamp同一时间基准)
+     * @return 碰撞告警列表，与在now时刻外推位置上的全量检测一致
+     */
+    std::vector<CollisionAlert> detectCollisionsAt(double now);
+    
+    /**
+     * 单船准入查询：假设boat_id船只处于hypothetical_state(如以某速度开始出坞)，
+     * 其他船只保持当前状态，返回该船将收到的告警(顺序与detectCollisions一致)
+     * 只通过空间网格检查该船的邻近船只，不重算整个船队。假设船只的船坞通道、
+     * 航线匹配与前船保存在查询的局部变量中，快照、航线索引与告警累加器均不修改；
+     * 除与检测相同的快照同步外没有副作用
+     * @param boat_id 船只ID，不在船队中时按新加入船只处理
+     * @param hypothetical_state 假设状态(sysid字段被忽略)
+     */
+    std::vector<CollisionAlert> evaluateBoat(int boat_id, const BoatState& hypothetical_state);
+    
+    /**
+     * 按船只当前状态执行单船查询，船只不存在时返回空列表
+     */
+    std::vector<CollisionAlert> evaluateBoat(int boat_id);
+    
+    /**
+     * 执行一次检测并更新实时告警表，只返回相对上次的变化：
+     * 新告警、等级升高、等级降低和告警解除。同一船只的同类告警在持续期间保持
+     * 相同的告警ID；等级回落要求碰撞时间超过阈值 alert_hysteresis_s 以上，
+     * 抑制碰撞时间在阈值附近波动造成的反复告警
+     */
+    std::vector<AlertDelta> detectAlertChanges();
+    
+    /**
+     * 以动态检测(detectCollisionsAt)更新实时告警表
+     */
+    std::vector<AlertDelta> detectAlertChangesAt(double now);
+    
+    /**
+     * 实时告警表：最近一次detectAlertChanges后处于告警状态的全部告警，不重新检测
+     */
+    const std::vector<CollisionAlert>& getCurrentAlerts() const;
+    
+    /**
+     * 用外部告警表替换实时告警表(保留告警ID与等级，供滞回和变化判断使用)
+     * 用于分片检测：船只在分片间移交时沿用合并后的全局告警表
+     */
+    void loadAlertTable(const std::vector<CollisionAlert>& alerts);
+    
+    /**
+     * 固定局部平面投影原点；多个检测器使用同一原点时结果逐位一致
+     */
+    void setProjectionOrigin(const GeoPoint& origin);
+    
+    /**
+     * 最大船速为max_speed时告警时域(含滞回量)内两船可能产生告警的最大间距(米)
+     */
+    static double getInteractionRange(const SystemConfig& config, double max_speed);
+    
+    /**
+     * 启用/关闭空间网格粗筛
+     * 关闭后退回两两暴力遍历，用于校验网格结果
+     */
+    void setBroadPhaseEnabled(bool enabled);
+    bool isBroadPhaseEnabled() const;
+    
+    /**
+     * 启用/关闭增量检测(见PairCache)
+     * 启用后只重新求解涉及状态变化船只的船对，其余船对复用上次结果，
+     * 每隔 full_revalidation_ticks 次检测做一次全量重算
+     */
+    void setIncrementalEnabled(bool enabled, int full_revalidation_ticks = 50);
+    bool isIncrementalEnabled() const;
+    
+    /**
+     * 启用/关闭自适应复查(见RecheckSchedule)
+     * 计划未到期的船对在告警时域内不可能成为告警，检测时跳过求解
+     */
+    void setAdaptiveRecheckEnabled(bool enabled, double max_interval_s = 5.0);
+    bool isAdaptiveRecheckEnabled() const;
+    
+    /**
+     * 设置检测线程数(0表示硬件并发数，1表示单线程)
+     * 工作线程在第一次需要并行的检测(船只数达到kMinParallelBoats)时才启动，
+     * 只用于单船查询或小船队的检测器不占用线程。多线程结果与单线程逐位一致，告警顺序确定
+     */
+    void setThreadCount(int threads);
+    size_t getThreadCount() const;
+    
+    /**
+     * 获取最近一次检测的统计信息
+     */
+    const DetectionStats& getLastStats() const;
+    
+    /**
+     * 动态检测记录状态版本的船只数(离开的船只不保留记录)
+     */
+    size_t getTrackedVersionCount() const;
+    
+    /**
+     * 告警槽位：出坞/入坞/跟随共用本船的主告警，对向航行单独累加
+     */
+    enum class AlertSlot { PRIMARY, ONCOMING };
+    
+    /**
+     * 检测规则的只读视图与累加接口(见rule_view.h)，Fields决定船只字段的来源
+     */
+    template <typename Fields> class BasicRuleView;
+    template <typename Fields> class BasicRuleContext;
+    
 private:
+    struct FleetFields;
+    struct ProbeFields;
+    
+public:
+    // 船队检测中的规则视图与累加接口
+    using RuleView = BasicRuleView<FleetFields>;
+    using RuleContext = BasicRuleContext<FleetFields>;
+    
+    /**
+     * 设置检测规则流水线(编译期规则集，见detection_rules.h)，默认为rules::DefaultRules
+     * 按规则集实例化候选评估、限时检测的船对枚举与归类，各规则的判断在其中内联展开；
+     * 检测器每个任务或每段船对记录经函数指针调用一次实例，不按船对调用
+     */
+    template <typename Pipeline>
+    void setRules();
+    
+private:
+    // 运动学剪枝距离界的相对/绝对余量，避免边界上的舍入误差误剪
+    static constexpr double kPruneMargin = 1.0 + 1e-9;
+    static constexpr double kPruneSlack = 1e-6;
+    // 每个并行任务处理的船只数，以及启用多线程的最小船只数
+    static constexpr size_t kBoatsPerTask = 32;
+    static constexpr size_t kMinParallelBoats = 256;
+    // 船只偏离投影原点超过该距离(米)时重新选取原点
+    static constexpr double kMaxOriginOffset = 20000.0;
+    // 限时检测每求解这么多船对检查一次时钟
+    static constexpr size_t kBudgetCheckInterval = 32;
+    
     SystemConfig config_;
-    std::map<int, BoatState> boat_states_;
-    std::vector<DockInfo> dock_info_;
-    std::vector<RouteInfo> route_info_;
+    std::vector<PackedBoatState> boat_states_;  // 紧凑记录，按船只ID升序，用于变化比较与重建snapshot_
+    
+    // 按船只ID升序排列的结构数组快照，下标即网格中的对象ID
+    BoatSnapshot snapshot_;
+    bool snapshot_stale_ = false;
+    bool snapshot_advanced_ = false;  // 快照位置已被动态检测外推
+    GeoPoint projection_origin_;
+    bool has_projection_origin_ = false;
+    
+    // 航线弧长索引与船坞通道成员：快照位置、航线或船坞变化后重建
+    RouteIndex route_index_;
+    DockCorridorIndex dock_index_;
+    bool route_index_stale_ = true;
+    
+    // 空间网格粗筛
+    bool broad_phase_enabled_ = true;
+    SpatialHashGrid grid_;
+    double max_boat_speed_ = 0.0;  // 每次快照重建时更新的最大船速界
+    
+    // 各检测模式的状态
+    PairCache pair_cache_;          // 增量检测
+    RecheckSchedule recheck_;       // 自适应复查
+    PairPriorityQueue budget_queue_;  // 限时检测
+    std::vector<PairPriorityQueue::Entry> budget_batch_;
+    std::vector<double> budget_times_;
+    std::vector<PairRecord> budget_records_;
+    KineticTracker kinetic_;        // 动态检测
+    AlertTable alert_table_;        // 实时告警表，只由detectAlertChanges更新
+    bool tracking_pass_ = false;    // 本次检测更新告警表，滞回只在这些检测中生效
+    
+    DetectionStats last_stats_;
+    
+    /**
+     * 每个工作者独占的批量求解暂存数组
+     */
+    struct PairScratch {
+        std::vector<int> candidates;
+        std::vector<size_t> solve_slots;
+        std::vector<double> batch_x;
+        std::vector<double> batch_y;
+        std::vector<double> batch_vx;
+        std::vector<double> batch_vy;
+        std::vector<double> batch_times;
+        std::vector<double> solved_times;
+        std::vector<uint8_t> corridor_skipped;  // 与candidates对应，船坞通道剪枝排除的船对为1
+    };
+    
+    /**
+     * 一个并行任务(一段连续船只)的输出，按(i, j)字典序排列
+     */
+    struct PairChunk {
+        std::vector<PairRecord> records;
+        std::vector<std::pair<uint64_t, double>> cache_updates;
+        std::vector<std::pair<uint64_t, RecheckSchedule::Entry>> recheck_updates;
+        std::vector<PairPriorityQueue::Entry> deferred;  // 限时检测中下界超过紧急阈值的船对
+        bool urgent_only = false;                        // 限时检测中只枚举了紧急距离内的船对
+        size_t candidate_pairs = 0;
+        size_t pruned_pairs = 0;
+        size_t solved_pairs = 0;
+        size_t cached_pairs = 0;
+        size_t corridor_pairs = 0;
+        size_t scheduled_pairs = 0;
+    
+        void reset();
+    };
+    
+    // 并行检测
+    size_t thread_count_ = 1;
+    std::unique_ptr<WorkStealingThreadPool> thread_pool_;  // 按需创建
+    std::vector<PairScratch> scratches_;
+    std::vector<PairChunk> chunks_;
     
     /**
-     * 检测出坞碰撞
+     * 本次检测使用的线程池：单线程或船只数不足时返回nullptr，否则按需创建
      */
-    std::vector<CollisionAlert> detectUndockingCollisions();
+    WorkStealingThreadPool* acquireThreadPool(size_t boat_count);
     
     /**
-     * 检测入坞碰撞
+     * 单船告警累加器
+     * 融合遍历中按对方船只ID升序依次累加，结果与逐类型单独遍历一致
      */
-    std::vector<CollisionAlert> detectDockingCollisions();
+    struct AlertAccumulator {
+        CollisionAlert alert;
+        double min_collision_time;
+        int closest_front_boat;
+        AlertLevel previous_level;  // 实时告警表中的上次等级，用于滞回
+    
+        void reset(int boat_id, double heading, AlertType type);
+    };
+    
+    // 每船两个累加器：出坞/入坞/跟随共用主累加器，对向航行单独累加
+    std::vector<AlertAccumulator> primary_accumulators_;
+    std::vector<AlertAccumulator> oncoming_accumulators_;
+    
+    // 每次检测的告警区：清空后复用已分配的容量
+    std::vector<CollisionAlert> alert_arena_;
+    
+    /**
+     * 单船查询中的假设船只：字段保存在查询的局部变量中，不写入快照与索引。
+     * 规则通过哨兵下标index(等于快照大小，不与任何船队下标重合)访问假设船只
+     */
+    struct ProbeBoat {
+        size_t index;
+        size_t fleet_index;   // 在船队中的下标，新加入的船只为快照大小
+        int sysid;
+        double x, y;
+        double vx, vy;
+        double hx, hy;
+        double heading;
+        double speed;
+        BoatStatus status;
+        RouteDirection route_direction;
+        int dock;             // 所在通道的船坞序号
+        int route;            // 匹配到的航线序号，-1表示未匹配
+        double arc;
+        int ahead;            // 同一航线上的最近前船下标
+        AlertAccumulator primary;
+        AlertAccumulator oncoming;
+    };
+    
+    // 单船查询中的规则视图与累加接口
+    using ProbeView = BasicRuleView<ProbeFields>;
+    using ProbeContext = BasicRuleContext<ProbeFields>;
+    
+    /**
+     * 按规则集实例化的检测阶段(setRules设置)
+     */
+    struct RuleStages {
+        void (CollisionDetector::*classify_records)(const PairRecord*, const PairRecord*);
+        void (CollisionDetector::*evaluate_range)(size_t, size_t, PairScratch&, PairChunk&) const;
+        void (CollisionDetector::*prioritize_range)(size_t, size_t, bool, PairScratch&, PairChunk&) const;
+        void (CollisionDetector::*classify_probe)(ProbeBoat&, const std::vector<int>&,
+                                                   const std::vector<double>&) const;
+    };
+    const RuleStages* rules_ = nullptr;
+    
+    template <typename Pipeline>
+    void classifyRecordsWith(const PairRecord* first, const PairRecord* last);
+    template <typename Pipeline>
+    void classifyPairWith(size_t self, size_t other, double collision_time);
+    template <typename Pipeline>
+    void evaluateBoatRangeWith(size_t begin, size_t end, PairScratch& scratch, PairChunk& out) const;
+    template <typename Pipeline>
+    void prioritizeBoatRangeWith(size_t begin, size_t end, bool urgent_only, PairScratch& scratch,
+                                 PairChunk& out) const;
+    template <typename Pipeline>
+    void classifyProbeWith(ProbeBoat& probe, const std::vector<int>& candidates,
+                           const std::vector<double>& times) const;
+    
+    /**
+     * 标记第i条船的候选船只中可由船坞通道剪枝排除的船对(结果写入scratch.corridor_skipped)，
+     * 港区没有船坞时清空标记
+     */
+    template <typename Pipeline>
+    void markCorridorSkipsWith(size_t i, PairScratch& scratch) const;
+    
+    /**
+     * 涉及船坞通道内船只、双方告警规则都不考虑对方的船对
+     */
+    template <typename Pipeline>
+    bool isCorridorSkippedBy(size_t i, size_t j) const;
+    
+    RuleView ruleView() const;
+    RuleContext ruleContext();
+    
+    /**
+     * 按(i, j)顺序对船对记录双向归类
+     */
+    void classifyRecords(const std::vector<PairRecord>& records);
+    
+    /**
+     * 求解下标在[begin, end)内船只作为较小下标的全部候选船对
+     * 只读取检测器状态，可在多个工作者上并发执行
+     */
+    void evaluateBoatRange(size_t begin, size_t end, PairScratch& scratch, PairChunk& out) const;
+    
+    /**
+     * 评估第i条船与其候选船只构成的无序船对：
+     * 用向量化内核批量求解碰撞时间，每对只求解一次，告警时域内的结果写入out。
+     * 船坞通道剪枝读取scratch.corridor_skipped中预先标记的结果
+     */
+    void evaluateCandidates(size_t i, PairScratch& scratch, PairChunk& out) const;
+    
+    /**
+     * 按任务顺序合并各任务输出：累加统计、写回缓存与复查计划，并按字典序为双方归类
+     */
+    void mergeChunks(size_t chunk_count);
+    
+    /**
+     * 限时检测：枚举下标在[begin, end)内船只作为较小下标的候选船对，
+     * 下界不超过紧急阈值的船对直接求解写入out.records，其余写入out.deferred。
+     * urgent_only时只枚举紧急距离内的船对。只读取检测器状态，可在多个工作者上并发执行
+     */
+    void prioritizeBoatRange(size_t begin, size_t end, bool urgent_only, PairScratch& scratch,
+                             PairChunk& out) const;
+    
+    /**
+     * 求解单个船对的碰撞时间
+     */
+    double solvePair(size_t i, size_t j) const;
+    
+    /**
+     * 在已同步的快照上评估假设船只，只读取检测器状态
+     */
+    std::vector<CollisionAlert> evaluateProbe(int boat_id, const BoatState& hypothetical_state) const;
+    
+    /**
+     * 为本次检测重置所有船只的累加器；跟踪检测时载入实时告警表中的上次等级
+     */
+    void resetAccumulators();
     
     /**
-     * 检测正常航行时的前后船碰撞
+     * 船只状态对应的主累加器告警类型
      */
-    std::vector<CollisionAlert> detectFollowingCollisions();
+    static AlertType primaryAlertType(BoatStatus status);
     
     /**
-     * 检测对向航行碰撞
+     * 碰撞时间处于滞回区间且本船没有需要维持的告警，船对不参与归类
      */
-    std::vector<CollisionAlert> detectOncomingCollisions();
+    bool isOnlyHysteresisRelevant(size_t self, double collision_time) const;
+    
+    /**
+     * 记录碰撞时间的改进并按本船位置(x, y)与速度(vx, vy)计算预计碰撞位置
+     */
+    void recordCollision(AlertAccumulator& acc, double x, double y, double vx, double vy,
+                         double collision_time) const;
+    
+    /**
+     * 将累加器结果按出坞、入坞、跟随、对向的顺序输出到告警区
+     */
+    void collectAlerts();
+    
+    /**
+     * 只输出一条船的告警，顺序与collectAlerts中该船的告警一致
+     */
+    std::vector<CollisionAlert> collectBoatAlerts(BoatStatus status, AlertAccumulator& primary,
+                                                  AlertAccumulator& oncoming) const;
+    
+    /**
+     * 填写碰撞时间与决策建议后输出累加器中的告警
+     */
+    void emitAlert(AlertAccumulator& acc, std::vector<CollisionAlert>& alerts) const;
     
     /**
      * 计算碰撞告警等级
+     * 上次等级较高时，碰撞时间需超过对应阈值 alert_hysteresis_s 以上才回落
+     */
+    AlertLevel calculateAlertLevel(double collision_time,
+                                   AlertLevel previous_level = AlertLevel::NORMAL) const;
+    
+    /**
+     * 本次检测的告警时域(秒)：跟踪检测时包含滞回量
+     */
+    double getAlertHorizon() const;
+    
+    /**
+     * 包含滞回量的最长告警时域(秒)，决定网格与动态检测时间窗
+     */
+    double getMaxAlertHorizon() const;
+    
+    /**
+     * 碰撞时间是否落在告警时域内
+     */
+    bool isAlertRelevant(double collision_time) const;
+    
+    /**
+     * 刷新快照与位置索引，恢复动态检测外推前的上报位置
+     */
+    void prepareSnapshot();
+    
+    /**
+     * 告警时域内可能发生碰撞的最大两船间距(米)
+     */
+    double getBroadPhaseRange() const;
+    
+    /**
+     * 船只状态变化后重建快照与空间网格，并生成按下标的待重算标记
+     */
+    void refreshSnapshot();
+    
+    /**
+     * 快照位置或航线变化后重建航线弧长索引
+     */
+    void refreshRouteIndex();
+    
+    /**
+     * 运动学剪枝：两船间距超过 (|v1|+|v2|)*T + R 时告警时域内不可能进入碰撞半径
+     */
+    bool isPrunedByReach(size_t i, size_t j) const;
+    
+    /**
+     * 两船碰撞时间的保守下界(秒)：间距减安全距离后按两船速度之和接近
+     */
+    double collisionTimeLowerBound(size_t i, size_t j) const;
+    
+    /**
+     * 船对缓存键(按船只ID，较小ID在高位)
      */
-    AlertLevel calculateAlertLevel(double collision_time) const;
+    uint64_t pairKey(size_t i, size_t j) const;
     
     /**
-     * 生成避碰决策建议
+     * 收集可能与第i条船发生碰撞且下标大于i的候选船只下标(升序)
      */
-    std::string generateDecisionAdvice(const CollisionAlert& alert) const;
+    void collectCandidates(size_t i, std::vector<int>& out) const;
     
     /**
      * 获取船只的碰撞半径
@@ -80,16 +534,17 @@ private:
     double getCollisionRadius() const;
     
     /**
-     * 判断两船是否在同一航线上
+     * 不在同一航线时的前船判断：对方位于本船航向(hx, hy)前方45度范围内
      */
-    bool isOnSameRoute(const BoatState& boat1, const BoatState& boat2) const;
+    static bool isAheadOfHeading(double dx, double dy, double hx, double hy);
     
     /**
-     * 判断两船是否对向航行
+     * 航线方向不同且航向差接近180度
      */
-    bool isOncomingTraffic(const BoatState& boat1, const BoatState& boat2) const;
+    static bool isOncomingHeading(RouteDirection direction_i, RouteDirection direction_j,
+                                  double heading_i, double heading_j);
 };
 
 } // namespace boat_pro
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,56 @@
+// ==================== include/collision_kernel.h ====================
+#ifndef BOAT_PRO_COLLISION_KERNEL_H
+#define BOAT_PRO_COLLISION_KERNEL_H
+
+#include <cstddef>
+
+namespace boat_pro {
+namespace geometry {
+
+/**
+ * 批量碰撞时间计算所使用的指令集
+ */
+enum class SimdBackend {
+    SCALAR = 0,  // 标量实现
+    NEON = 1,    // ARM NEON，每次2x2路
+    AVX2 = 2,    // x86 AVX2，每次4路
+    AVX512 = 3   // x86 AVX-512F，每次8路
+};
+
+/**
+ * 运行时检测到的最优指令集(首次调用时检测CPU特性并缓存)
+ */
+SimdBackend detectSimdBackend();
+
+/**
+ * 指令集名称，用于日志输出
+ */
+const char* simdBackendName(SimdBackend backend);
+
+/**
+ * 一条船对一组连续存放的船只批量计算碰撞时间
+ * 结果与逐对调用 calculateCollisionTime(dx, dy, dvx, dvy, radius) 一致
+ * @param x0,y0 本船局部平面坐标(米)
+ * @param vx0,vy0 本船速度(m/s)
+ * @param xs,ys,vxs,vys 其他船只的坐标与速度数组，长度为count
+ * @param radius 碰撞半径(米)
+ * @param out 输出碰撞时间(秒)，不会碰撞时为-1
+ */
+void calculateCollisionTimes(double x0, double y0, double vx0, double vy0,
+                             const double* xs, const double* ys,
+                             const double* vxs, const double* vys,
+                             size_t count, double radius, double* out);
+
+/**
+ * 使用指定指令集批量计算碰撞时间；CPU不支持时退回标量实现
+ */
+void calculateCollisionTimes(SimdBackend backend,
+                             double x0, double y0, double vx0, double vy0,
+                             const double* xs, const double* ys,
+                             const double* vxs, const double* vys,
+                             size_t count, double radius, double* out);
+
+} // namespace geometry
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,262 @@
+// ==================== include/detection_rules.h ====================
+#ifndef BOAT_PRO_DETECTION_RULES_H
+#define BOAT_PRO_DETECTION_RULES_H
+
+#include "collision_detector.h"
+#include "rule_view.h"
+#include <algorithm>
+
+namespace boat_pro {
+namespace rules {
+
+/**
+ * 检测规则策略
+ * 每条规则是一个提供两个静态函数模板的类型：
+ *   template <typename View>
+ *   static bool applies(const View& view, size_t self, size_t other);
+ *     船对过滤：本船(self)的该规则是否考虑对方船只(与碰撞时间无关)，
+ *     同时用于船坞通道剪枝判断船对能否被排除
+ *   template <typename Context>
+ *   static void classify(Context& context, size_t self, size_t other, double collision_time);
+ *     归类：通过过滤的船对按碰撞时间累加到本船的告警槽位
+ * View/Context为CollisionDetector::BasicRuleView/BasicRuleContext(见rule_view.h)：
+ * 船队检测读取快照与索引，单船查询读取假设船只的局部字段，判断与累加接口相同
+ * 规则集在编译期展开为一串内联判断：setRules按规则集实例化候选评估、限时检测的船对枚举与归类，
+ * 检测器只在每个任务或每段船对记录处经函数指针调用一次实例，船对循环内没有间接调用；
+ * 新增规则不增加遍历次数。
+ * 告警仍按出坞、入坞、跟随、对向的顺序输出：出坞/入坞船只输出主告警，
+ * 正常航行船只有最近前船时输出主告警(跟随)，对向槽位有告警时输出对向告警
+ */
+
+/**
+ * 出坞：本船通道内及驶入通道的所有船只
+ */
+struct UndockingRule {
+    template <typename View>
+    static bool applies(const View& view, size_t self, size_t other) {
+        return view.status(self) == BoatStatus::UNDOCKING && view.isCorridorRelevant(self, other);
+    }
+
+    template <typename Context>
+    static void classify(Context& context, size_t self, size_t other, double collision_time) {
+        using Slot = CollisionDetector::AlertSlot;
+        if (!context.record(Slot::PRIMARY, self, collision_time)) return;
+
+        // 根据优先级判断：只有入坞和正常航行船只需要出坞船只让行
+        BoatStatus other_status = context.status(other);
+        if (other_status != BoatStatus::DOCKING && other_status != BoatStatus::NORMAL_SAIL) return;
+        context.updateLevel(Slot::PRIMARY, self, collision_time);
+        if (context.isOncomingTraffic(self, other)) {
+            context.addOncomingBoat(Slot::PRIMARY, self, other);
+        } else {
+            context.addFrontBoat(Slot::PRIMARY, self, other);
+        }
+    }
+};
+
+/**
+ * 入坞：入坞船只具有最高优先级，同航线其他船只需要避让
+ */
+struct DockingRule {
+    template <typename View>
+    static bool applies(const View& view, size_t self, size_t other) {
+        return view.status(self) == BoatStatus::DOCKING && view.isOnSameRoute(self, other) &&
+               view.isCorridorRelevant(self, other);
+    }
+
+    template <typename Context>
+    static void classify(Context& context, size_t self, size_t other, double collision_time) {
+        using Slot = CollisionDetector::AlertSlot;
+        if (!context.record(Slot::PRIMARY, self, collision_time)) return;
+        context.updateLevel(Slot::PRIMARY, self, collision_time);
+        context.addFrontBoat(Slot::PRIMARY, self, other);
+    }
+};
+
+/**
+ * 跟随：同航线同向航行时只考虑本船的前船
+ */
+struct FollowingRule {
+    template <typename View>
+    static bool applies(const View& view, size_t self, size_t other) {
+        return view.status(self) == BoatStatus::NORMAL_SAIL && view.isOnSameRoute(self, other) &&
+               !view.isOncomingTraffic(self, other) && view.isAhead(self, other);
+    }
+
+    template <typename Context>
+    static void classify(Context& context, size_t self, size_t other, double collision_time) {
+        using Slot = CollisionDetector::AlertSlot;
+        if (!context.record(Slot::PRIMARY, self, collision_time)) return;
+        context.setClosestFrontBoat(self, other);
+        context.updateLevel(Slot::PRIMARY, self, collision_time);
+    }
+};
+
+/**
+ * 对向：正常航行船只与对向航行船只
+ */
+struct OncomingRule {
+    template <typename View>
+    static bool applies(const View& view, size_t self, size_t other) {
+        return view.status(self) == BoatStatus::NORMAL_SAIL && view.isOncomingTraffic(self, other);
+    }
+
+    template <typename Context>
+    static void classify(Context& context, size_t self, size_t other, double collision_time) {
+        using Slot = CollisionDetector::AlertSlot;
+        if (!context.record(Slot::ONCOMING, self, collision_time)) return;
+        context.updateLevel(Slot::ONCOMING, self, collision_time);
+        context.addOncomingBoat(Slot::ONCOMING, self, other);
+    }
+};
+
+/**
+ * 规则流水线：按模板参数顺序依次应用各规则
+ */
+template <typename... Rules>
+struct RulePipeline {
+    template <typename View>
+    static bool applies(const View& view, size_t self, size_t other) {
+        return (Rules::applies(view, self, other) || ...);
+    }
+
+    template <typename Context>
+    static void classify(Context& context, size_t self, size_t other, double collision_time) {
+        ((Rules::applies(context, self, other)
+              ? Rules::classify(context, self, other, collision_time)
+              : void()),
+         ...);
+    }
+};
+
+/**
+ * 默认规则集：出坞、入坞、跟随、对向
+ */
+using DefaultRules = RulePipeline<UndockingRule, DockingRule, FollowingRule, OncomingRule>;
+
+} // namespace rules
+
+template <typename Pipeline>
+void CollisionDetector::setRules() {
+    static const RuleStages stages{
+        &CollisionDetector::classifyRecordsWith<Pipeline>,
+        &CollisionDetector::evaluateBoatRangeWith<Pipeline>,
+        &CollisionDetector::prioritizeBoatRangeWith<Pipeline>,
+        &CollisionDetector::classifyProbeWith<Pipeline>,
+    };
+    rules_ = &stages;
+}
+
+template <typename Pipeline>
+void CollisionDetector::classifyPairWith(size_t self, size_t other, double collision_time) {
+    if (isOnlyHysteresisRelevant(self, collision_time)) return;
+    RuleContext context = ruleContext();
+    Pipeline::classify(context, self, other, collision_time);
+}
+
+template <typename Pipeline>
+void CollisionDetector::classifyRecordsWith(const PairRecord* first, const PairRecord* last) {
+    for (; first != last; ++first) {
+        classifyPairWith<Pipeline>(first->i, first->j, first->collision_time);
+        classifyPairWith<Pipeline>(first->j, first->i, first->collision_time);
+    }
+}
+
+template <typename Pipeline>
+void CollisionDetector::classifyProbeWith(ProbeBoat& probe, const std::vector<int>& candidates,
+                                          const std::vector<double>& times) const {
+    // 查询不包含滞回，只归类碰撞时间在告警阈值内的船对
+    ProbeContext context(ProbeFields{*this, probe});
+    for (size_t k = 0; k < candidates.size(); ++k) {
+        if (times[k] > 0 && times[k] <= config_.warning_threshold_s) {
+            Pipeline::classify(context, probe.index, static_cast<size_t>(candidates[k]), times[k]);
+        }
+    }
+}
+
+template <typename Pipeline>
+void CollisionDetector::evaluateBoatRangeWith(size_t begin, size_t end, PairScratch& scratch,
+                                              PairChunk& out) const {
+    for (size_t i = begin; i < end; ++i) {
+        collectCandidates(i, scratch.candidates);
+        markCorridorSkipsWith<Pipeline>(i, scratch);
+        evaluateCandidates(i, scratch, out);
+    }
+}
+
+template <typename Pipeline>
+void CollisionDetector::markCorridorSkipsWith(size_t i, PairScratch& scratch) const {
+    std::vector<uint8_t>& skipped = scratch.corridor_skipped;
+    skipped.clear();
+    if (dock_index_.empty()) return;
+    
+    skipped.resize(scratch.candidates.size());
+    for (size_t k = 0; k < skipped.size(); ++k) {
+        skipped[k] = isCorridorSkippedBy<Pipeline>(i, static_cast<size_t>(scratch.candidates[k]));
+    }
+}
+
+template <typename Pipeline>
+bool CollisionDetector::isCorridorSkippedBy(size_t i, size_t j) const {
+    // 涉及通道内船只的船对，双方的告警规则都不考虑对方时无需求解
+    RuleView view = ruleView();
+    return !dock_index_.empty() &&
+           (dock_index_.getDock(i) != DockCorridorIndex::kNoDock ||
+            dock_index_.getDock(j) != DockCorridorIndex::kNoDock) &&
+           !Pipeline::applies(view, i, j) && !Pipeline::applies(view, j, i);
+}
+
+template <typename Pipeline>
+void CollisionDetector::prioritizeBoatRangeWith(size_t begin, size_t end, bool urgent_only,
+                                                PairScratch& scratch, PairChunk& out) const {
+    // 紧急距离内才可能有下界不超过紧急阈值的船对
+    double emergency = config_.emergency_threshold_s;
+    double urgent_range = (2.0 * max_boat_speed_ * emergency + getCollisionRadius()) * kPruneMargin +
+                          kPruneSlack;
+    std::vector<int>& candidates = scratch.candidates;
+    out.urgent_only = urgent_only;
+    for (size_t i = begin; i < end; ++i) {
+        // 船对稍后按下界重新排序，候选船只无需按下标排序
+        if (broad_phase_enabled_) {
+            candidates.clear();
+            grid_.queryNeighbors(snapshot_.x[i], snapshot_.y[i], candidates);
+        } else {
+            collectCandidates(i, candidates);
+        }
+        for (int candidate : candidates) {
+            size_t j = static_cast<size_t>(candidate);
+            if (j <= i) continue;
+            if (urgent_only) {
+                double dx = snapshot_.x[j] - snapshot_.x[i];
+                double dy = snapshot_.y[j] - snapshot_.y[i];
+                if (dx * dx + dy * dy > urgent_range * urgent_range) continue;
+            }
+            ++out.candidate_pairs;
+            if (isPrunedByReach(i, j)) {
+                ++out.pruned_pairs;
+                continue;
+            }
+            if (isCorridorSkippedBy<Pipeline>(i, j)) {
+                ++out.corridor_pairs;
+                continue;
+            }
+            
+            // 紧急类船对始终求解，其余船对留待按下界排序
+            double lower_bound = collisionTimeLowerBound(i, j);
+            if (lower_bound <= emergency) {
+                ++out.solved_pairs;
+                double collision_time = solvePair(i, j);
+                if (isAlertRelevant(collision_time)) {
+                    out.records.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(j),
+                                           collision_time});
+                }
+            } else {
+                out.deferred.push_back({lower_bound, static_cast<uint32_t>(i), static_cast<uint32_t>(j)});
+            }
+        }
+    }
+}
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,75 @@
+// ==================== include/detection_types.h ====================
+#ifndef BOAT_PRO_DETECTION_TYPES_H
+#define BOAT_PRO_DETECTION_TYPES_H
+
+#include "types.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace boat_pro {
+
+/**
+ * 单次检测的统计信息
+ */
+struct DetectionStats {
+    size_t boat_count = 0;          // 参与检测的船只数
+    size_t candidate_pairs = 0;     // 粗筛后的候选船对数
+    size_t pruned_pairs = 0;        // 运动学距离界排除的船对数
+    size_t solved_pairs = 0;        // 实际求解碰撞时间的船对数
+    size_t cached_pairs = 0;        // 复用缓存结果的船对数
+    bool full_revalidation = true;  // 本次是否为全量重算
+    double max_speed = 0.0;         // 本次快照的最大船速(m/s)，决定网格边长
+    size_t kinetic_events = 0;      // 动态检测处理的到期证书事件数
+    size_t corridor_pairs = 0;      // 涉及船坞通道内船只、双方告警规则均不考虑对方而排除的船对数
+    bool budget_exhausted = false;  // 限时检测是否在覆盖全部候选船对前用完时间预算
+    size_t deferred_pairs = 0;      // 限时检测因预算耗尽未求解的船对数
+    double covered_horizon_s = 0.0; // 碰撞时间小于此值(秒)的风险保证已完整检测
+    size_t scheduled_pairs = 0;     // 自适应复查未到期而跳过求解的船对数
+};
+
+/**
+ * 告警时域内的船对求解结果(i < j，均为快照下标)
+ */
+struct PairRecord {
+    uint32_t i;
+    uint32_t j;
+    double collision_time;
+};
+
+namespace detection {
+
+// 网格边长相对候选距离的放大系数及最小边长(米)，吸收局部投影误差
+constexpr double kGridRangeMargin = 1.01;
+constexpr double kGridMinCellSize = 1.0;
+
+/**
+ * 船只的碰撞半径：安全距离设为船只长度的2倍
+ */
+inline double collisionRadius(const SystemConfig& config) {
+    return config.boat.length * 2.0;
+}
+
+/**
+ * 包含滞回量的最长告警时域(秒)
+ */
+inline double maxAlertHorizon(const SystemConfig& config) {
+    return config.warning_threshold_s + std::max(0.0, config.alert_hysteresis_s);
+}
+
+/**
+ * 船对键(按船只ID，较小ID在高位)
+ */
+inline uint64_t pairKey(int lo_id, int hi_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(lo_id)) << 32) |
+           static_cast<uint64_t>(static_cast<uint32_t>(hi_id));
+}
+
+inline int pairKeyLo(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key >> 32)); }
+inline int pairKeyHi(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key)); }
+
+} // namespace detection
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,87 @@
+// ==================== include/dock_corridor_index.h ====================
+#ifndef BOAT_PRO_DOCK_CORRIDOR_INDEX_H
+#define BOAT_PRO_DOCK_CORRIDOR_INDEX_H
+
+#include "types.h"
+#include "boat_snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 船坞进出通道索引
+ * 每个船坞的进出通道取为以船坞为圆心、给定半径的圆形区域。船坞按通道外接方框
+ * 登记到边长为两倍半径的网格单元中，按位置查找所在通道只需访问一个单元。
+ * 出坞/入坞船只只需考虑位于本船通道内或在告警时域内驶入该通道的船只
+ */
+class DockCorridorIndex {
+public:
+    static constexpr int kNoDock = -1;
+
+    /**
+     * 设置船坞信息
+     */
+    void setDocks(const std::vector<DockInfo>& docks);
+
+    /**
+     * 按快照投影船坞并确定每条船所在的通道
+     * @param snapshot 船只快照，船坞按其投影原点投影
+     * @param radius 通道半径(米)，不大于0时不建立通道
+     */
+    void build(const BoatSnapshot& snapshot, double radius);
+
+    bool empty() const { return docks_.empty(); }
+
+    /**
+     * 局部平面上的点所在通道的船坞序号，位于多个通道时取最近的船坞，不在任何通道时返回kNoDock
+     */
+    int locate(double x, double y) const;
+
+    /**
+     * 船只(快照下标)所在通道的船坞序号
+     */
+    int getDock(size_t boat) const;
+
+    /**
+     * 覆盖船只所在通道(用于临时写入快照的假设状态)
+     */
+    void setBoatDock(size_t boat, int dock);
+
+    /**
+     * 以(vx, vy)匀速航行的船只在horizon秒内是否位于或驶入船坞通道
+     */
+    bool reaches(int dock, double x, double y, double vx, double vy, double horizon) const;
+
+    int getDockId(int dock) const { return docks_[dock].dock_id; }
+    double getDockX(int dock) const { return docks_[dock].x; }
+    double getDockY(int dock) const { return docks_[dock].y; }
+    double getRadius() const { return radius_; }
+
+private:
+    struct Dock {
+        int dock_id;
+        double x;
+        double y;
+    };
+
+    std::vector<DockInfo> dock_info_;
+    std::vector<Dock> docks_;
+    double radius_ = 0.0;
+    GeoPoint origin_;
+    bool projected_ = false;
+
+    double cell_size_ = 1.0;
+    std::unordered_map<uint64_t, std::vector<int>> cells_;  // 单元键 -> 通道与该单元相交的船坞
+    std::vector<int> boat_docks_;
+
+    void projectDocks(const BoatSnapshot& snapshot, double radius);
+    int32_t cellCoord(double v) const;
+    static uint64_t cellKey(int32_t cx, int32_t cy);
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,133 @@
+// ==================== include/fast_trig.h ====================
+#ifndef BOAT_PRO_FAST_TRIG_H
+#define BOAT_PRO_FAST_TRIG_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace boat_pro {
+namespace geometry {
+namespace fast {
+
+/**
+ * 快速近似三角函数
+ * 缩减到小区间后用最小最大(Remez)多项式逼近，不查表，只用乘加与比较。
+ * 批量计算的AVX2实现(geometry_utils.cpp)使用相同的缩减方法与系数。
+ * 最大误差(在整个定义域上实测)：
+ *   sin/cos   |x| <= 1e6 时绝对误差 < 1e-10
+ *   atan2     绝对误差 < 5e-10 弧度
+ *   asin      绝对误差 < 5e-10 弧度
+ * 按地球半径换算，大圆角误差5e-10弧度约合3毫米。不处理NaN与无穷大；
+ * atan2的结果带y的符号位(y为-0.0时返回-0.0或-π)
+ */
+
+namespace detail {
+
+// 大于2^52的数加减后舍入到整数(默认舍入模式为就近舍入)
+constexpr double kRoundMagic = 6755399441055744.0;  // 1.5 * 2^52
+
+// π/2 拆分为高低两部分，缩减时高位部分的乘积无舍入误差
+constexpr double kHalfPiHi = 1.5707963267341256;
+constexpr double kHalfPiLo = 6.077100506506192e-11;
+constexpr double kTwoOverPi = 0.6366197723675814;
+
+constexpr double kPi = 3.141592653589793;
+constexpr double kHalfPi = 1.5707963267948966;
+constexpr double kQuarterPi = 0.7853981633974483;
+constexpr double kTanEighthPi = 0.41421356237309503;
+
+// 多项式系数按幂次升序排列，由Remez交错点迭代求得
+// sin(r)/r 在 r^2 ∈ [0, (π/4)^2] 上的逼近，相对误差 4.3e-12
+constexpr double kSinCoeffs[] = {0.9999999999956816, -0.1666666663163548, 0.008333328786053714,
+                                 -0.0001983920314486209, 2.717353244367944e-06};
+// cos(r) 在 r^2 ∈ [0, (π/4)^2] 上的逼近，绝对误差 4.7e-11
+constexpr double kCosCoeffs[] = {0.9999999999526005, -0.49999999615433516, 0.04166661673920854,
+                                 -0.0013886619210267245, 2.4379929377639857e-05};
+// atan(t)/t 在 t^2 ∈ [0, tan(π/8)^2] 上的逼近，相对误差 5.9e-10
+constexpr double kAtanCoeffs[] = {0.9999999994122798, -0.33333308081375523, 0.1999823820780035,
+                                  -0.1424043019484027, 0.10575793571491413, -0.06040186651770188};
+
+template<size_t N>
+inline double horner(const double (&coeffs)[N], double z) {
+    double p = coeffs[N - 1];
+    for (size_t i = N - 1; i-- > 0;) p = p * z + coeffs[i];
+    return p;
+}
+
+inline double sinPoly(double r) { return r * horner(kSinCoeffs, r * r); }
+inline double cosPoly(double r) { return horner(kCosCoeffs, r * r); }
+inline double atanPoly(double t) { return t * horner(kAtanCoeffs, t * t); }
+
+} // namespace detail
+
+/**
+ * 同时计算正弦与余弦
+ */
+inline void sincos(double x, double& out_sin, double& out_cos) {
+    using namespace detail;
+    // x = k·π/2 + r，|r| <= π/4；加上舍入常数后尾数低位即为k的补码，直接取出象限
+    double shifted = x * kTwoOverPi + kRoundMagic;
+    double k = shifted - kRoundMagic;
+    double r = (x - k * kHalfPiHi) - k * kHalfPiLo;
+    double s = sinPoly(r);
+    double c = cosPoly(r);
+
+    // 按象限交换并取符号
+    uint64_t quadrant;
+    std::memcpy(&quadrant, &shifted, sizeof(quadrant));
+    bool swap = (quadrant & 1) != 0;
+    double sin_value = swap ? c : s;
+    double cos_value = swap ? s : c;
+    out_sin = (quadrant & 2) != 0 ? -sin_value : sin_value;
+    out_cos = ((quadrant + 1) & 2) != 0 ? -cos_value : cos_value;
+}
+
+inline double sin(double x) {
+    double s, c;
+    sincos(x, s, c);
+    return s;
+}
+
+inline double cos(double x) {
+    double s, c;
+    sincos(x, s, c);
+    return c;
+}
+
+/**
+ * 四象限反正切，取值范围[-π, π]
+ */
+inline double atan2(double y, double x) {
+    using namespace detail;
+    double ax = std::abs(x);
+    double ay = std::abs(y);
+    bool steep = ay > ax;
+    double hi = steep ? ay : ax;
+    double lo = steep ? ax : ay;
+    double a = hi > 0 ? lo / hi : 0.0;
+
+    // a > tan(π/8) 时利用 atan(a) = π/4 + atan((a-1)/(a+1)) 缩减到 |t| <= tan(π/8)
+    bool reduce = a > kTanEighthPi;
+    double t = reduce ? (a - 1.0) / (a + 1.0) : a;
+    double angle = (reduce ? kQuarterPi : 0.0) + atanPoly(t);
+
+    angle = steep ? kHalfPi - angle : angle;
+    angle = x < 0 ? kPi - angle : angle;
+    return std::copysign(angle, y);
+}
+
+/**
+ * 反正弦，x超出[-1, 1]时按边界处理
+ */
+inline double asin(double x) {
+    double c = (1.0 - x) * (1.0 + x);
+    return atan2(x, std::sqrt(c > 0 ? c : 0.0));
+}
+
+} // namespace fast
+} // namespace geometry
+} // namespace boat_pro
+
+#endif
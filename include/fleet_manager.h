@@ -4,9 +4,18 @@
 
 #include "types.h"
 #include "collision_detector.h"
+#include "boat_snapshot.h"
+#include "boat_state_store.h"
+#include "harbor_rtree.h"
+#include "region_partitioner.h"
+#include "route_index.h"
+#include "thread_pool.h"
 #include "udp_communicator.h"
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 namespace boat_pro {
 
@@ -18,14 +27,23 @@ namespace boat_pro {
 class FleetManager {
 public:
     using AlertCallback = std::function<void(const CollisionAlert&)>;
+    using AlertDeltaCallback = std::function<void(const AlertDelta&)>;
     
     FleetManager(const SystemConfig& config = SystemConfig::getDefault());
+    ~FleetManager();
     
     /**
      * 设置碰撞告警回调函数
      */
     void setAlertCallback(AlertCallback callback);
     
+    /**
+     * 设置告警变化回调函数
+     * 只在告警新增、等级升高、等级降低和解除时调用；告警回调同样只收到
+     * 发生变化的告警(解除时等级为NORMAL)
+     */
+    void setAlertDeltaCallback(AlertDeltaCallback callback);
+    
     /**
      * 初始化船坞信息
      */
@@ -55,11 +73,12 @@ public:
     
     /**
      * 更新船只状态
+     * 可在通信回调等任意线程调用：状态暂存到快照存储，下一次检测前一次合并发布，不等待碰撞检测
      */
     void updateBoatState(const BoatState& boat);
     
     /**
-     * 批量更新船只状态
+     * 批量更新船只状态(整体替换船队)
      */
     void updateBoatStates(const std::vector<BoatState>& boats);
     
@@ -82,24 +101,37 @@ public:
     bool requestDocking(int boat_id);
     
     /**
-     * 获取推荐的船坞
+     * 获取推荐的船坞：离船只最新位置最近的船坞，尚无该船状态时为第一个船坞
      */
     int getRecommendedDock(int boat_id);
     
     /**
-     * 运行安全监控循环
+     * 在后台线程运行安全监控循环
      */
     void runSafetyMonitoring();
     
     /**
-     * 停止安全监控
+     * 停止安全监控并等待监控线程退出
      */
     void stopSafetyMonitoring();
     
     /**
-     * 获取当前所有碰撞告警
+     * 执行一次检测：发布实时告警表并将告警变化分发给回调
+     * 监控循环每周期调用一次；未运行监控时由调用方按自己的周期调用
+     */
+    void runDetectionPass();
+    
+    /**
+     * 获取当前所有碰撞告警：读取最近一次runDetectionPass发布的实时告警表，不执行检测
      */
-    std::vector<CollisionAlert> getCurrentAlerts();
+    std::vector<CollisionAlert> getCurrentAlerts() const;
+    
+    /**
+     * 按最新船队状态立即执行一次检测并返回告警
+     * 不更新实时告警表与滞回状态，不分发回调，告警ID为0；
+     * 告警变化只由runDetectionPass产生，调用本函数不会使回调漏掉或重复收到变化
+     */
+    std::vector<CollisionAlert> detectNow();
     
     /**
      * 【新增】获取通信统计信息
@@ -111,8 +143,98 @@ private:
     std::unique_ptr<CollisionDetector> collision_detector_;
     std::vector<DockInfo> dock_info_;
     std::vector<RouteInfo> route_info_;
+    HarborRTree harbor_index_;  // 船坞的空间索引，船坞信息变化时重建
     AlertCallback alert_callback_;
-    bool monitoring_active_;
+    AlertDeltaCallback alert_delta_callback_;
+    std::atomic<bool> monitoring_active_;
+    std::thread monitoring_thread_;
+    
+    // 写入方发布船队快照，检测方按版本同步到碰撞检测器
+    BoatStateStore state_store_;
+    std::mutex detection_mutex_;  // 保护碰撞检测器，只在检测方之间串行
+    uint64_t detected_version_;
+    
+    // 实时告警表，每次检测后整体替换，只通过 std::atomic_load/std::atomic_store 访问
+    std::shared_ptr<const std::vector<CollisionAlert>> live_alerts_;
+    
+    // 光环宽度相对最大作用距离的放大系数及绝对余量(米)，吸收划分与检测投影的差异
+    static constexpr double kShardHaloMargin = 1.01;
+    static constexpr double kShardHaloSlack = 1.0;
+    
+    // 按投影距离筛选最近船坞候选时的相对余量与绝对余量(米)，覆盖局部平面与大圆距离的差异
+    static constexpr double kDockProjectionTolerance = 0.01;
+    static constexpr double kDockProjectionSlack = 1.0;
+    
+    // 地理分片检测(detection_shards大于1时启用)：每个分片一个检测器，
+    // 合并各分片本片船只的告警，告警ID与变化事件由合并后的全局告警表决定
+    RegionPartitioner partitioner_;
+    GeoPoint shard_origin_;            // 各分片共用的投影原点
+    std::vector<std::unique_ptr<CollisionDetector>> shard_detectors_;
+    std::unique_ptr<WorkStealingThreadPool> shard_pool_;
+    uint64_t sharded_version_;
+    bool has_shard_origin_;
+    uint64_t next_alert_id_;
+    std::vector<CollisionAlert> merged_alerts_;
+    std::vector<std::vector<CollisionAlert>> shard_tables_;
+    std::vector<std::vector<AlertDelta>> shard_deltas_;
+    
+    /**
+     * 航线上的一条船只：弧长、船只ID及其在所属分片本片船只中的序号
+     */
+    struct RouteSlot {
+        double arc;
+        int sysid;
+        uint32_t shard;
+        uint32_t item;
+    };
+    
+    // 航线前船补充：各分片并行定位本片船只，再按航线合并排序得到全船队中的前船
+    std::vector<std::vector<PackedBoatState>> shard_owned_;  // 各分片的本片船只(ID升序)
+    std::vector<BoatSnapshot> shard_snapshots_;            // 各分片本片船只的快照
+    std::vector<RouteIndex> shard_route_indexes_;          // 各分片本片船只的航线弧长索引
+    std::vector<std::vector<RouteSlot>> route_slots_;      // 每条航线上的船只，按(弧长, ID)排序
+    std::vector<std::vector<int>> shard_leaders_;          // 各分片本片船只的前船ID，没有前船为-1
+    
+    /**
+     * 将最新发布的船队快照同步到碰撞检测器后执行检测(调用方须持有detection_mutex_)
+     * @return 相对上次检测的告警变化
+     */
+    std::vector<AlertDelta> detectLatest();
+    
+    /**
+     * 按地理分片并行检测并合并各分片告警(调用方须持有detection_mutex_)
+     * @return 相对上次检测的告警变化，顺序与单一检测器一致
+     */
+    std::vector<AlertDelta> detectSharded();
+    
+    /**
+     * 在分片的本片船只上建立航线弧长索引(各分片可并行调用)
+     */
+    void locateShardBoats(size_t shard);
+    
+    /**
+     * 合并各分片定位结果，按航线排序后为每条本片船只找出全船队中沿航线弧长最近的前船
+     * 各分片与单一检测器使用相同的投影原点和航线匹配，前船与单一检测器一致
+     */
+    void linkRouteLeaders();
+    
+    /**
+     * 把本片船只的前船补入本片(各分片可并行调用)
+     * 折返或弯曲航线上，弧长最近的前船可能远在光环之外，而较远的船只在空间上更近；
+     * 补入后分片内的跟随判断与单一检测器一致
+     */
+    void addRouteLeaders(size_t shard, const FleetSnapshot& fleet);
+    
+    /**
+     * 最近一次检测后的告警表(调用方须持有detection_mutex_)
+     */
+    const std::vector<CollisionAlert>& latestAlerts() const;
+    
+    /**
+     * 将最新发布的船队快照同步到碰撞检测器(调用方须持有detection_mutex_)
+     * @return 同步所用的快照
+     */
+    BoatStateStore::SnapshotPtr syncDetector();
     
     // 【新增】通信组件
     std::unique_ptr<communication::UDPCommunicator> communicator_;
@@ -3,7 +3,9 @@
 #define BOAT_PRO_GEOMETRY_UTILS_H
 
 #include "types.h"
+#include "local_projector.h"
 #include <cmath>
+#include <cstddef>
 
 namespace boat_pro {
 namespace geometry {
@@ -11,6 +13,15 @@ namespace geometry {
 // 地球半径 (米)
 constexpr double EARTH_RADIUS = 6371000.0;
 
+/**
+ * 距离/方位角/目标点计算使用的三角函数实现
+ */
+enum class TrigMode {
+    EXACT = 0,  // 标准库实现
+    FAST = 1    // 多项式逼近(fast_trig.h)，批量计算在支持AVX2的CPU上4路并行；
+                // 大圆角误差<5e-10弧度，港区范围内位置误差在毫米量级
+};
+
 /**
  * 计算两个地理坐标点之间的距离 (米)
  * 使用Haversine公式
@@ -28,6 +39,53 @@ double calculateBearing(const GeoPoint& from, const GeoPoint& to);
  */
 GeoPoint calculateDestination(const GeoPoint& start, double bearing, double distance);
 
+/**
+ * 按指定三角函数实现计算距离、方位角与目标点
+ */
+double calculateDistance(TrigMode mode, const GeoPoint& p1, const GeoPoint& p2);
+double calculateBearing(TrigMode mode, const GeoPoint& from, const GeoPoint& to);
+GeoPoint calculateDestination(TrigMode mode, const GeoPoint& start, double bearing, double distance);
+
+/**
+ * 一个原点到一组连续存放的坐标点的距离 (米)
+ * 结果与逐点调用 calculateDistance(origin, 点) 一致，原点纬度的三角函数只计算一次
+ * @param lats,lngs 目标点纬度与经度数组，长度为count
+ * @param out 输出距离，长度为count
+ */
+void calculateDistances(const GeoPoint& origin, const double* lats, const double* lngs,
+                        size_t count, double* out);
+
+/**
+ * 一个原点到一组连续存放的坐标点的方位角 (度)
+ * 结果与逐点调用 calculateBearing(origin, 点) 一致
+ */
+void calculateBearings(const GeoPoint& origin, const double* lats, const double* lngs,
+                       size_t count, double* out);
+
+/**
+ * 一组起始点分别按各自的方位角与距离计算目标点
+ * 结果与逐点调用 calculateDestination 一致；输出数组可与输入坐标数组相同(原地推进)
+ * @param lats,lngs 起始点坐标数组
+ * @param bearings 方位角数组(度)
+ * @param distances 距离数组(米)
+ * @param out_lats,out_lngs 输出目标点坐标数组
+ */
+void calculateDestinations(const double* lats, const double* lngs,
+                           const double* bearings, const double* distances,
+                           size_t count, double* out_lats, double* out_lngs);
+
+/**
+ * 按指定三角函数实现批量计算距离、方位角与目标点
+ * 只有FAST模式在支持AVX2的CPU上4路并行；EXACT模式逐点调用标准库，与上面的重载相同
+ */
+void calculateDistances(TrigMode mode, const GeoPoint& origin, const double* lats, const double* lngs,
+                        size_t count, double* out);
+void calculateBearings(TrigMode mode, const GeoPoint& origin, const double* lats, const double* lngs,
+                       size_t count, double* out);
+void calculateDestinations(TrigMode mode, const double* lats, const double* lngs,
+                           const double* bearings, const double* distances,
+                           size_t count, double* out_lats, double* out_lngs);
+
 /**
  * 将度数转换为弧度
  */
@@ -70,6 +128,35 @@ double calculateCollisionTime(const GeoPoint& pos1, const GeoPoint& vel1,
                              const GeoPoint& pos2, const GeoPoint& vel2,
                              double radius);
 
+/**
+ * 使用已构造的局部投影计算碰撞时间，逐对调用时不再重复计算原点三角函数
+ * @param projector 港区局部投影，速度按其原点处的缩放系数换算
+ */
+double calculateCollisionTime(const LocalProjector& projector,
+                             const GeoPoint& pos1, const GeoPoint& vel1,
+                             const GeoPoint& pos2, const GeoPoint& vel2,
+                             double radius);
+
+/**
+ * 局部平面坐标系下的碰撞时间
+ * @param dx 物体2相对物体1的东向位置(m)
+ * @param dy 物体2相对物体1的北向位置(m)
+ * @param dvx 物体2相对物体1的东向速度(m/s)
+ * @param dvy 物体2相对物体1的北向速度(m/s)
+ * @param radius 碰撞半径(m)
+ * @return 碰撞时间(秒)，如果不会碰撞返回-1
+ */
+double calculateCollisionTime(double dx, double dy, double dvx, double dvy, double radius);
+
+/**
+ * 局部平面坐标系下两物体距离小于碰撞半径的时间区间
+ * @param t_enter 进入碰撞半径的时刻(秒，相对当前，可为负)
+ * @param t_exit 离开碰撞半径的时刻(秒，相对当前，可为负)
+ * @return 相对运动轨迹是否会进入碰撞半径
+ */
+bool calculateCollisionInterval(double dx, double dy, double dvx, double dvy, double radius,
+                                double& t_enter, double& t_exit);
+
 } // namespace geometry
 } // namespace boat_pro
 
@@ -0,0 +1,81 @@
+// ==================== include/harbor_rtree.h ====================
+#ifndef BOAT_PRO_HARBOR_RTREE_H
+#define BOAT_PRO_HARBOR_RTREE_H
+
+#include "types.h"
+#include "local_projector.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 港区船坞静态R树
+ * 船坞位置投影到以首个船坞为原点的局部平面，按STR(Sort-Tile-Recursive)方式一次性装填：
+ * 逐层按中心x排序分成竖条，条内按中心y排序后每kNodeCapacity个打包成一个节点，
+ * 节点包围盒紧凑且互相重叠很少。只在船坞信息变化时重建，查询最近的k个船坞或
+ * 半径范围内的船坞时只访问附近的节点。航段由各航线的 RouteGeometry 索引，不在本树中
+ */
+class HarborRTree {
+public:
+    /**
+     * 查询结果
+     */
+    struct Hit {
+        size_t item;      // 船坞在输入中的序号
+        double distance;  // 局部平面上的距离(米)
+    };
+
+    /**
+     * 重建索引
+     */
+    void build(const std::vector<DockInfo>& docks);
+
+    bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+    const geometry::LocalProjector& getProjector() const { return projector_; }
+
+    /**
+     * 离点最近的k个船坞，按距离升序，距离相同时按序号升序
+     */
+    void nearest(const GeoPoint& point, size_t k, std::vector<Hit>& out) const;
+    void nearest(double px, double py, size_t k, std::vector<Hit>& out) const;
+
+    /**
+     * 与点距离不超过radius(米)的船坞，排序同nearest
+     */
+    void withinRadius(const GeoPoint& point, double radius, std::vector<Hit>& out) const;
+    void withinRadius(double px, double py, double radius, std::vector<Hit>& out) const;
+
+private:
+    struct Entry {
+        double min_x, min_y, max_x, max_y;  // 船坞为点，包围盒退化为该点
+        uint32_t item;
+    };
+
+    struct Node {
+        double min_x, min_y, max_x, max_y;
+        uint32_t begin;  // 叶节点指向entries_，内部节点指向nodes_中连续存放的子节点
+        uint32_t count;
+        bool leaf;
+    };
+
+    static constexpr size_t kNodeCapacity = 8;
+
+    geometry::LocalProjector projector_;
+    std::vector<Entry> entries_;  // 按叶节点顺序存放
+    std::vector<Node> nodes_;     // 自底向上逐层存放，最后一个为根
+
+    template <typename Box>
+    static double boxDistanceSq(const Box& box, double px, double py);
+    template <typename Box>
+    static void packLevel(std::vector<Box>& boxes, size_t begin, size_t end,
+                          std::vector<Node>& parents, bool leaf);
+    static bool hitLess(const Hit& a, const Hit& b);
+    Hit makeHit(const Entry& entry, double distance_sq) const;
+};
+
+} // namespace boat_pro
+
+#endif
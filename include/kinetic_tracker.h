@@ -0,0 +1,156 @@
+// ==================== include/kinetic_tracker.h ====================
+#ifndef BOAT_PRO_KINETIC_TRACKER_H
+#define BOAT_PRO_KINETIC_TRACKER_H
+
+#include "types.h"
+#include "boat_snapshot.h"
+#include "detection_types.h"
+#include "spatial_hash_grid.h"
+#include <cstdint>
+#include <queue>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 动态(kinetic)检测的证书表
+ * 每个邻近船对保存一张证书(线性运动下进入/离开碰撞半径的时刻)，证书在告警等级
+ * 可能变化的时刻进入事件队列；每次检测只处理到期事件和状态更新过的船只涉及的船对，
+ * 维护处于告警时间窗内的船对集合
+ */
+class KineticTracker {
+public:
+    explicit KineticTracker(const SystemConfig& config);
+
+    /**
+     * 船只状态变化(含新加入)：递增状态版本，下次检测时重新签发其证书
+     */
+    void markChanged(int boat_id);
+
+    /**
+     * 船队成员或投影原点变化，下次检测重建网格
+     */
+    void markMembershipChanged() { membership_changed_ = true; }
+
+    /**
+     * 船只离开：删除其状态版本记录。版本号全局递增，涉及它的证书在其重新加入后也不会复活
+     */
+    void forget(int boat_id);
+
+    /**
+     * 记录状态版本的船只数
+     */
+    size_t getTrackedVersionCount() const { return boat_versions_.size(); }
+
+    /**
+     * 开始一次检测：首次检测、时间回退或投影原点变化时清空证书并以now为新的时间基准
+     * @return 相对时间基准的检测时刻
+     */
+    double begin(double now, const GeoPoint& origin);
+
+    /**
+     * 在外推到检测时刻的快照上更新证书与告警时间窗船对，统计累加到stats
+     * @param time begin返回的相对检测时刻
+     */
+    void update(const BoatSnapshot& snapshot, double time, double max_speed, DetectionStats& stats);
+
+    /**
+     * 告警时间窗内证书仍然有效、碰撞时间在(0, horizon]内的船对，按ID字典序追加到records
+     */
+    void collectWarningPairs(const BoatSnapshot& snapshot, double time, double horizon,
+                             std::vector<PairRecord>& records);
+
+private:
+    // 网格的有效期(相对告警阈值)及证书时间窗的余量(秒)
+    static constexpr double kGridHorizon = 0.5;
+    static constexpr double kWindowSlack = 1e-6;
+
+    /**
+     * 船对证书：线性运动下两船处于碰撞半径内的时间区间(相对epoch_)，
+     * 以及求解时双方的状态版本；任一船只状态更新后证书失效。
+     * 不会再进入碰撞半径的船对也保存证书(collides为false)，避免重建网格时重复求解
+     */
+    struct Certificate {
+        bool collides;
+        double enter_time;
+        double exit_time;
+        uint64_t version_lo;
+        uint64_t version_hi;
+        uint64_t generation;
+    };
+
+    /**
+     * 证书事件：船对进入或离开告警时间窗的时刻
+     */
+    struct Event {
+        double time;
+        uint64_t key;
+        uint64_t generation;
+
+        bool operator>(const Event& other) const { return time > other.time; }
+    };
+
+    double collision_radius_;
+    double warning_threshold_;
+    double max_alert_horizon_;
+
+    bool active_ = false;
+    bool membership_changed_ = true;
+    double epoch_ = 0.0;        // 证书时间基准(绝对时间)
+    double now_ = 0.0;          // 上次检测时刻(相对基准)
+    double grid_time_ = 0.0;    // 网格对应时刻(相对基准)
+    double grid_expiry_ = 0.0;  // 网格失效时刻(相对基准)
+    double grid_speed_ = 0.0;   // 建网格时的最大船速
+    GeoPoint origin_;
+    SpatialHashGrid grid_;      // 以船只ID为对象，位置为grid_time_时刻
+    std::vector<int> moved_;    // 建网格后状态更新过的船只ID
+    std::unordered_set<int> dirty_ids_;  // 上次检测以来状态更新的船只ID
+    std::vector<int> candidates_;
+    std::unordered_map<int, uint64_t> boat_versions_;  // 在册船只的状态版本(全局递增编号)
+    uint64_t next_boat_version_ = 0;
+    std::unordered_map<uint64_t, Certificate> certificates_;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+    std::set<std::pair<int, int>> warning_pairs_;  // 处于告警时间窗内的船对(ID升序)
+    uint64_t next_generation_ = 0;
+
+    /**
+     * 以now时刻(相对基准)的位置重建网格，并为所有无有效证书的邻近船对签发证书
+     */
+    void rebuildGrid(const BoatSnapshot& snapshot, double now, double max_speed, DetectionStats& stats);
+
+    /**
+     * 为状态更新过的船只重新签发与其邻近船只的证书
+     */
+    void recertifyMovedBoat(const BoatSnapshot& snapshot, size_t i, double now, DetectionStats& stats);
+
+    /**
+     * 若船对(i < j)没有有效证书，则在now时刻求解并签发
+     */
+    void certifyPair(const BoatSnapshot& snapshot, size_t i, size_t j, double now, DetectionStats& stats);
+
+    /**
+     * 处理所有不晚于now的证书事件，更新告警时间窗内的船对集合
+     */
+    void processEvents(double now, DetectionStats& stats);
+
+    bool isCertificateValid(uint64_t key, const Certificate& cert) const;
+    uint64_t getBoatVersion(int boat_id) const;
+
+    /**
+     * 证书在time时刻是否处于告警时间窗内，以及time之后的下一个窗口边界
+     */
+    bool isInWarningWindow(const Certificate& cert, double time) const;
+    double nextWindowBoundary(const Certificate& cert, double time) const;
+
+    /**
+     * 证书在time时刻对应的碰撞时间(语义同geometry::calculateCollisionTime)
+     */
+    static double collisionTime(const Certificate& cert, double time);
+};
+
+} // namespace boat_pro
+
+#endif
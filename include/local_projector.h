@@ -0,0 +1,68 @@
+// ==================== include/local_projector.h ====================
+#ifndef BOAT_PRO_LOCAL_PROJECTOR_H
+#define BOAT_PRO_LOCAL_PROJECTOR_H
+
+#include "types.h"
+
+namespace boat_pro {
+namespace geometry {
+
+/**
+ * 局部切平面(东-北)投影
+ * 以港区原点构造一次，原点纬度的三角函数与各缩放系数预先计算，
+ * 每次投影只需乘加，不调用三角函数。在等距投影基础上加入二阶曲率修正：
+ *   东向 x = Δλ·(kx - kxy·Δφ)，经线收敛使经度缩放随纬度变化
+ *   北向 y = Δφ·ky + kyy·Δλ²，纬线相对切平面的弯曲
+ * (Δφ、Δλ为相对原点的纬度、经度差，单位度)。原点周围10公里内与切平面坐标的
+ * 偏差在厘米量级，反投影与投影互逆(误差远小于1毫米)
+ */
+class LocalProjector {
+public:
+    LocalProjector();
+    explicit LocalProjector(const GeoPoint& origin);
+
+    /**
+     * 重新设置原点并更新缩放系数
+     */
+    void recenter(const GeoPoint& origin);
+
+    const GeoPoint& getOrigin() const { return origin_; }
+
+    /**
+     * 经纬度投影到局部平面(米)
+     */
+    void project(double latitude, double longitude, double& out_x, double& out_y) const {
+        double dlat = latitude - origin_.lat;
+        double dlng = longitude - origin_.lng;
+        out_x = dlng * (kx_ - kxy_ * dlat);
+        out_y = dlat * ky_ + kyy_ * dlng * dlng;
+    }
+
+    /**
+     * 局部平面坐标(米)反投影为经纬度
+     */
+    GeoPoint unproject(double px, double py) const;
+
+    /**
+     * 从point出发沿东向east、北向north(米)平移后的位置
+     */
+    GeoPoint translate(const GeoPoint& point, double east, double north) const;
+
+    /**
+     * 原点处每度纬度/经度对应的米数，用于换算速度等增量
+     */
+    double getMetersPerDegLat() const { return ky_; }
+    double getMetersPerDegLng() const { return kx_; }
+
+private:
+    GeoPoint origin_;
+    double kx_;   // 原点纬度处每度经度的米数
+    double ky_;   // 每度纬度的米数
+    double kxy_;  // 经度缩放随纬度的变化率(米/度²)
+    double kyy_;  // 纬线弯曲项系数(米/度²)
+};
+
+} // namespace geometry
+} // namespace boat_pro
+
+#endif
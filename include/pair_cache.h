@@ -0,0 +1,85 @@
+// ==================== include/pair_cache.h ====================
+#ifndef BOAT_PRO_PAIR_CACHE_H
+#define BOAT_PRO_PAIR_CACHE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 增量检测的船对碰撞时间缓存
+ * 记录自上次检测以来状态变化的船只；双方都未变化的船对复用上次求解的碰撞时间，
+ * 每隔 full_revalidation_ticks 次检测做一次全量重算并清除长期未使用的缓存项
+ */
+class PairCache {
+public:
+    /**
+     * 启用/关闭增量检测，下次检测全量重算
+     */
+    void configure(bool enabled, int full_revalidation_ticks);
+    bool isEnabled() const { return enabled_; }
+
+    /**
+     * 下次检测全量重算(如投影原点变化或本次检测未写回缓存)
+     */
+    void requestFullPass() { force_full_ = true; }
+
+    /**
+     * 开始一次检测，返回本次是否全量重算
+     */
+    bool beginPass();
+    bool isFullPass() const { return full_pass_; }
+
+    /**
+     * 本次检测能否复用缓存结果
+     */
+    bool isReusable() const { return enabled_ && !full_pass_; }
+
+    void markDirty(int boat_id) { dirty_ids_.insert(boat_id); }
+
+    /**
+     * 快照重建后按下标生成待重算标记
+     */
+    void mapDirty(const std::vector<int>& sysids);
+
+    /**
+     * 船对(i, j)双方都未变化且有缓存结果时写出碰撞时间并返回true
+     */
+    bool lookup(size_t i, size_t j, uint64_t key, double& collision_time) const;
+
+    /**
+     * 写入本次求解结果(合并阶段串行调用)
+     */
+    void store(uint64_t key, double collision_time);
+
+    /**
+     * 结束一次检测：全量重算后删除本轮未写入的缓存项，并清除待重算标记
+     */
+    void endPass();
+
+private:
+    /**
+     * 缓存项，stamp为最近一次写入时的全量重算轮次
+     */
+    struct CachedPair {
+        double collision_time;
+        uint64_t stamp;
+    };
+
+    bool enabled_ = false;
+    int full_revalidation_ticks_ = 50;
+    int ticks_since_full_revalidation_ = 0;
+    bool force_full_ = true;
+    bool full_pass_ = true;
+    std::unordered_set<int> dirty_ids_;
+    std::vector<uint8_t> boat_dirty_;
+    std::unordered_map<uint64_t, CachedPair> cache_;
+    uint64_t stamp_ = 0;
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,61 @@
+// ==================== include/pair_priority_queue.h ====================
+#ifndef BOAT_PRO_PAIR_PRIORITY_QUEUE_H
+#define BOAT_PRO_PAIR_PRIORITY_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 限时检测的候选船对队列
+ * 船对按碰撞时间保守下界建成小顶堆，按下界从小到大分批取出，
+ * 排序开销只与实际求解的船对数有关。下界相同按(i, j)排序，结果确定
+ */
+class PairPriorityQueue {
+public:
+    struct Entry {
+        double lower_bound;
+        uint32_t i;
+        uint32_t j;
+    };
+
+    void clear();
+
+    /**
+     * 追加船对(建堆前调用)
+     */
+    void append(const std::vector<Entry>& entries);
+
+    /**
+     * 追加的船对总数
+     */
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * 以全部追加的船对建堆
+     */
+    void heapify();
+
+    /**
+     * 堆中剩余的船对数及其中的最小下界
+     */
+    size_t remaining() const { return heap_end_; }
+    double nextLowerBound() const { return entries_.front().lower_bound; }
+
+    /**
+     * 按下界从小到大取出至多count个船对，写入out(先清空)
+     */
+    void popBatch(size_t count, std::vector<Entry>& out);
+
+private:
+    std::vector<Entry> entries_;
+    size_t heap_end_ = 0;
+
+    static bool later(const Entry& a, const Entry& b);
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,88 @@
+// ==================== include/recheck_schedule.h ====================
+#ifndef BOAT_PRO_RECHECK_SCHEDULE_H
+#define BOAT_PRO_RECHECK_SCHEDULE_H
+
+#include "types.h"
+#include "boat_snapshot.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 自适应复查计划
+ * 求解后按安全余量((距离-碰撞半径)/接近速度 减去告警时域)为船对安排下次复查时刻：
+ * 余量不足时每次检测都复查，较远或相互远离的船对间隔 1~max_interval_s 秒复查。
+ * 未到期期间任一船速度变化超过容差即提前复查。时钟取快照中最新的上报时间戳
+ */
+class RecheckSchedule {
+public:
+    /**
+     * 计划项：下次复查时刻(快照时钟)及安排时双方的速度分量，next_check<0表示删除
+     */
+    struct Entry {
+        double next_check;
+        float vx_i, vy_i;
+        float vx_j, vy_j;
+    };
+
+    explicit RecheckSchedule(const SystemConfig& config);
+
+    /**
+     * 启用/关闭复查计划，清空已有计划
+     */
+    void configure(bool enabled, double max_interval_s);
+    bool isEnabled() const { return enabled_; }
+
+    /**
+     * 本次检测是否有计划可用于跳过求解
+     */
+    bool isActive() const { return enabled_ && !schedule_.empty(); }
+
+    /**
+     * 按快照中最新的上报时间戳推进时钟，定期清理已过期的计划项
+     */
+    void advanceClock(const std::vector<double>& timestamps);
+
+    /**
+     * 船对(i, j)的计划尚未到期且双方速度变化均在容差内
+     */
+    bool isDeferred(uint64_t key, const BoatSnapshot& snapshot, size_t i, size_t j) const;
+
+    /**
+     * 为刚求解的船对生成计划项；返回false表示无需写回(余量不足且本次没有计划可删除)
+     * @param alert_relevant 碰撞时间是否落在告警时域内(此时每次检测都复查)
+     */
+    bool plan(const BoatSnapshot& snapshot, size_t i, size_t j, bool alert_relevant,
+              Entry& out) const;
+
+    /**
+     * 写回计划项(合并阶段串行调用)
+     */
+    void apply(uint64_t key, const Entry& entry);
+
+private:
+    // 最小复查间隔(秒)、安全余量折算为间隔的系数、接近速度的附加容差及单船速度变化容差(m/s)
+    static constexpr double kMinInterval = 1.0;
+    static constexpr double kSafetyFactor = 0.5;
+    static constexpr double kSpeedTolerance = 1.0;
+    static constexpr double kVelocityDrift = 0.5 * kSpeedTolerance;
+
+    double collision_radius_;
+    double max_alert_horizon_;
+    bool enabled_ = false;
+    double max_interval_ = 5.0;
+    double now_ = 0.0;
+    double next_sweep_ = 0.0;
+    std::unordered_map<uint64_t, Entry> schedule_;
+
+    /**
+     * 按求解时的相对运动计算船对的复查间隔(秒)，不足最小间隔时返回0(每次都复查)
+     */
+    double interval(const BoatSnapshot& snapshot, size_t i, size_t j) const;
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,74 @@
+// ==================== include/region_partitioner.h ====================
+#ifndef BOAT_PRO_REGION_PARTITIONER_H
+#define BOAT_PRO_REGION_PARTITIONER_H
+
+#include "types.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 地理分片划分器
+ * 沿船队跨度较大的坐标轴按船只数等分为若干条带，每条船只归属其位置所在的条带。
+ * 每个分片除本片船只外还包含距条带边界不超过光环宽度的邻片船只(光环船只)，
+ * 光环宽度不小于告警时域内两船可能相互作用的最大距离，因此本片船只的全部告警
+ * 都能在分片内独立检测；合并时只采用本片船只的告警，跨界船对的告警不会重复
+ */
+class RegionPartitioner {
+public:
+    static constexpr int kNoShard = -1;
+
+    explicit RegionPartitioner(size_t shard_count = 1);
+
+    /**
+     * 按船只位置重新划分分片
+     * @param boats 全部船只(按ID升序)
+     * @param halo_m 光环宽度(米)
+     */
+    void partition(const std::vector<PackedBoatState>& boats, double halo_m);
+
+    size_t getShardCount() const { return shards_.size(); }
+
+    /**
+     * 分片内的船只(本片船只与光环船只，按ID升序)
+     */
+    const std::vector<PackedBoatState>& getShardBoats(size_t shard) const;
+
+    /**
+     * 向分片追加一条光环船只(已在分片内时忽略)，分片内船只保持ID升序
+     */
+    void addBoat(size_t shard, const PackedBoatState& boat);
+
+    /**
+     * 分片的本片船只数
+     */
+    size_t getOwnedCount(size_t shard) const;
+
+    /**
+     * 船只归属的分片，船只不存在时返回kNoShard
+     */
+    int getOwner(int boat_id) const;
+
+    double getHalo() const { return halo_; }
+
+private:
+    struct Shard {
+        std::vector<PackedBoatState> boats;
+        size_t owned_count = 0;
+    };
+
+    std::vector<Shard> shards_;
+    std::vector<double> boundaries_;  // 相邻条带间的分界坐标(米)，升序
+    std::vector<double> coords_;      // 各船沿划分轴的坐标，与船只遍历顺序一致
+    std::vector<double> cross_coords_;  // 各船沿另一轴的坐标，只在划分时暂存
+    std::unordered_map<int, int> owners_;
+    double halo_ = 0.0;
+
+    size_t shardOf(double coord) const;
+};
+
+} // namespace boat_pro
+
+#endif
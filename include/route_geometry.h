@@ -0,0 +1,94 @@
+// ==================== include/route_geometry.h ====================
+#ifndef BOAT_PRO_ROUTE_GEOMETRY_H
+#define BOAT_PRO_ROUTE_GEOMETRY_H
+
+#include "types.h"
+#include "local_projector.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 航线折线几何表
+ * 航线点投影到局部平面后，按航段连续存放起点、单位方向向量、长度与起点处的累计弧长，
+ * 查询时不再做球面计算。航段按顺序两两合并建立包围盒层次，点到航线的投影与距离
+ * 查询只需沿树下降访问附近的航段，航段数为n时为O(log n)
+ */
+class RouteGeometry {
+public:
+    /**
+     * 点在航线上的投影
+     */
+    struct Projection {
+        size_t segment = 0;  // 所在航段
+        double arc = 0.0;    // 投影点的累计弧长(米)
+        double offset = 0.0; // 点到投影点的距离(米)
+        bool aligned = true; // 给定航向与航段方向是否一致(夹角不超过90度)
+    };
+
+    /**
+     * 投影航线并建立几何表
+     * @param points 航线点(按航行方向排列)
+     * @param projector 局部平面投影
+     */
+    void build(const std::vector<GeoPoint>& points, const geometry::LocalProjector& projector);
+
+    size_t segmentCount() const { return length_.size(); }
+    bool empty() const { return length_.empty(); }
+    double totalLength() const { return empty() ? 0.0 : arc_.back() + length_.back(); }
+
+    /**
+     * 离点最近的航段上的投影，距离相同时取序号较小的航段
+     * @return 航线为空时返回false
+     */
+    bool nearest(double px, double py, Projection& out) const;
+
+    /**
+     * 点到航线的最短距离(米)，航线为空时返回无穷大
+     */
+    double distanceTo(double px, double py) const;
+
+    /**
+     * 在max_offset范围内按航向选择航段：优先选择方向与航向一致的航段，其次取距离最近者，
+     * 仍相同时取序号较小者，使首尾折返、相互重叠的航段能够区分
+     * @param heading_x,heading_y 航向单位向量
+     * @param best 当前最佳候选，仅当本航线上有更优的航段时覆盖；跨航线比较时依次传入，
+     *             初始应为 aligned=false、offset=无穷大
+     * @return 是否覆盖了best
+     */
+    bool locate(double px, double py, double heading_x, double heading_y, double max_offset,
+                Projection& best) const;
+
+private:
+    struct Node {
+        double min_x, min_y, max_x, max_y;
+        uint32_t begin, end;  // 覆盖的航段区间 [begin, end)
+        int32_t left = -1;    // 叶节点的子节点为-1
+        int32_t right = -1;
+    };
+
+    static constexpr uint32_t kLeafSegments = 4;
+
+    // 各航段(结构数组)
+    std::vector<double> start_x_;
+    std::vector<double> start_y_;
+    std::vector<double> dir_x_;   // 单位方向向量，零长度航段为(0, 0)
+    std::vector<double> dir_y_;
+    std::vector<double> length_;
+    std::vector<double> arc_;     // 航段起点处的累计弧长
+
+    std::vector<Node> nodes_;     // nodes_[0]为根
+
+    int32_t buildNode(uint32_t begin, uint32_t end);
+    void projectOnSegment(size_t k, double px, double py, Projection& out) const;
+    static double boxDistanceSq(const Node& node, double px, double py);
+    void nearestIn(int32_t node, double px, double py, Projection& best, double& best_sq) const;
+    bool locateIn(int32_t node, double px, double py, double heading_x, double heading_y,
+                  double max_offset, Projection& best) const;
+};
+
+} // namespace boat_pro
+
+#endif
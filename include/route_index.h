@@ -0,0 +1,120 @@
+// ==================== include/route_index.h ====================
+#ifndef BOAT_PRO_ROUTE_INDEX_H
+#define BOAT_PRO_ROUTE_INDEX_H
+
+#include "types.h"
+#include "boat_snapshot.h"
+#include "route_geometry.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 航线弧长索引
+ * 将航线折线投影到快照的局部平面，把每条船匹配到与其航线方向一致的最近航线上，
+ * 以沿航线的弧长表示船只位置，并按弧长对每条航线上的船只排序，
+ * 用于查询同一航线上前方最近的船只
+ */
+class RouteIndex {
+public:
+    static constexpr int kNoBoat = -1;
+
+    /**
+     * 设置航线信息(航线点按航行方向排列)
+     */
+    void setRoutes(const std::vector<RouteInfo>& routes);
+
+    /**
+     * 按快照中的船只位置重建索引
+     * @param snapshot 船只快照，航线按其投影原点投影
+     * @param max_offset 船只到航线的最大横向距离(米)，超出则视为不在航线上
+     */
+    void build(const BoatSnapshot& snapshot, double max_offset);
+
+    bool empty() const { return routes_.empty(); }
+
+    /**
+     * 船只(快照下标)是否匹配到某条航线
+     */
+    bool isMatched(size_t boat) const;
+
+    /**
+     * 船只所在航线ID，未匹配时返回-1
+     */
+    int getRouteId(size_t boat) const;
+
+    /**
+     * 船只所在航线在索引中的序号(与locate的out_route一致)，未匹配时返回-1
+     */
+    int getRoute(size_t boat) const;
+
+    /**
+     * 船只在所在航线上的弧长位置(米)
+     */
+    double getArcLength(size_t boat) const;
+
+    /**
+     * 两船是否匹配到同一条航线
+     */
+    bool isOnSameRoute(size_t i, size_t j) const;
+
+    /**
+     * 同一航线上弧长大于本船的最近船只下标，不存在时返回kNoBoat
+     */
+    int nearestAhead(size_t boat) const;
+
+    /**
+     * 指定航线上弧长大于arc_length的最近船只下标(二分查找)，不存在时返回kNoBoat
+     */
+    int nearestAheadOf(int route_id, double arc_length) const;
+
+    /**
+     * 不在索引中的船只位于航线序号route的arc_length处时，其前方最近的船只下标。
+     * 弧长相同时按下标次序决定前后，order为该船在快照中的次序；
+     * exclude为该船在索引中的旧位置(新加入的船只传入快照大小)，不视为前船
+     */
+    int nearestAheadAt(int route, double arc_length, size_t order, size_t exclude) const;
+
+    /**
+     * 将局部平面上的点投影到航线上
+     * @param heading_x 航向单位向量东向分量，用于在重叠航段间选择同向航段
+     * @param heading_y 航向单位向量北向分量
+     * @param direction 只匹配该方向的航线
+     * @param out_route 匹配到的航线在索引中的序号
+     * @param out_arc 弧长位置(米)
+     * @return 是否在max_offset范围内匹配到航线
+     */
+    bool locate(double px, double py, double heading_x, double heading_y,
+                RouteDirection direction, double max_offset,
+                int& out_route, double& out_arc) const;
+
+private:
+    struct Polyline {
+        int route_id;
+        RouteDirection direction;
+        RouteGeometry geometry;  // 按投影原点预先计算的航段表
+    };
+
+    struct BoatPosition {
+        int route = -1;    // 航线序号，-1表示未匹配
+        double arc = 0.0;
+        size_t rank = 0;   // 在所在航线按弧长排序中的位置
+    };
+
+    std::vector<RouteInfo> route_info_;
+    std::vector<Polyline> routes_;
+    GeoPoint origin_;
+    bool projected_ = false;
+
+    std::vector<BoatPosition> boat_positions_;
+    std::vector<std::vector<std::pair<double, size_t>>> boats_by_arc_;  // 每条航线上的(弧长, 船只下标)
+
+    void projectRoutes(const BoatSnapshot& snapshot);
+    int findRoute(int route_id) const;
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,193 @@
+// ==================== include/rule_view.h ====================
+#ifndef BOAT_PRO_RULE_VIEW_H
+#define BOAT_PRO_RULE_VIEW_H
+
+#include "collision_detector.h"
+
+namespace boat_pro {
+
+/**
+ * 船队检测的船只字段：快照、航线索引与船坞通道成员，累加到每船的累加器
+ * 只读视图不持有累加器(primary/oncoming为空)
+ */
+struct CollisionDetector::FleetFields {
+    const CollisionDetector& detector;
+    AlertAccumulator* primary;
+    AlertAccumulator* oncoming;
+
+    double x(size_t boat) const { return detector.snapshot_.x[boat]; }
+    double y(size_t boat) const { return detector.snapshot_.y[boat]; }
+    double vx(size_t boat) const { return detector.snapshot_.vx[boat]; }
+    double vy(size_t boat) const { return detector.snapshot_.vy[boat]; }
+    double hx(size_t boat) const { return detector.snapshot_.hx[boat]; }
+    double hy(size_t boat) const { return detector.snapshot_.hy[boat]; }
+    double heading(size_t boat) const { return detector.snapshot_.heading[boat]; }
+    BoatStatus status(size_t boat) const { return detector.snapshot_.status[boat]; }
+    int sysid(size_t boat) const { return detector.snapshot_.sysid[boat]; }
+    RouteDirection routeDirection(size_t boat) const { return detector.snapshot_.route_direction[boat]; }
+    int route(size_t boat) const { return detector.route_index_.getRoute(boat); }
+    int aheadOnRoute(size_t boat) const { return detector.route_index_.nearestAhead(boat); }
+    int dock(size_t boat) const { return detector.dock_index_.getDock(boat); }
+    double corridorHorizon() const { return detector.getAlertHorizon(); }
+
+    AlertAccumulator& accumulator(AlertSlot slot, size_t boat) const {
+        return slot == AlertSlot::ONCOMING ? oncoming[boat] : primary[boat];
+    }
+};
+
+/**
+ * 单船查询的船只字段：哨兵下标读取假设船只的局部字段，其余下标读取快照与索引。
+ * 查询只以假设船只为本船(self)归类，累加到假设船只的局部累加器
+ */
+struct CollisionDetector::ProbeFields {
+    const CollisionDetector& detector;
+    ProbeBoat& probe;
+
+    bool isProbe(size_t boat) const { return boat == probe.index; }
+    double x(size_t boat) const { return isProbe(boat) ? probe.x : detector.snapshot_.x[boat]; }
+    double y(size_t boat) const { return isProbe(boat) ? probe.y : detector.snapshot_.y[boat]; }
+    double vx(size_t boat) const { return isProbe(boat) ? probe.vx : detector.snapshot_.vx[boat]; }
+    double vy(size_t boat) const { return isProbe(boat) ? probe.vy : detector.snapshot_.vy[boat]; }
+    double hx(size_t boat) const { return isProbe(boat) ? probe.hx : detector.snapshot_.hx[boat]; }
+    double hy(size_t boat) const { return isProbe(boat) ? probe.hy : detector.snapshot_.hy[boat]; }
+    double heading(size_t boat) const {
+        return isProbe(boat) ? probe.heading : detector.snapshot_.heading[boat];
+    }
+    BoatStatus status(size_t boat) const {
+        return isProbe(boat) ? probe.status : detector.snapshot_.status[boat];
+    }
+    int sysid(size_t boat) const { return isProbe(boat) ? probe.sysid : detector.snapshot_.sysid[boat]; }
+    RouteDirection routeDirection(size_t boat) const {
+        return isProbe(boat) ? probe.route_direction : detector.snapshot_.route_direction[boat];
+    }
+    int route(size_t boat) const {
+        return isProbe(boat) ? probe.route : detector.route_index_.getRoute(boat);
+    }
+    int aheadOnRoute(size_t boat) const {
+        return isProbe(boat) ? probe.ahead : detector.route_index_.nearestAhead(boat);
+    }
+    int dock(size_t boat) const {
+        return isProbe(boat) ? probe.dock : detector.dock_index_.getDock(boat);
+    }
+    // 查询不包含滞回，告警时域为告警阈值
+    double corridorHorizon() const { return detector.config_.warning_threshold_s; }
+
+    AlertAccumulator& accumulator(AlertSlot slot, size_t) const {
+        return slot == AlertSlot::ONCOMING ? probe.oncoming : probe.primary;
+    }
+};
+
+/**
+ * 检测规则的只读视图：船只字段与船对几何关系判断
+ */
+template <typename Fields>
+class CollisionDetector::BasicRuleView {
+public:
+    explicit BasicRuleView(const Fields& fields) : fields_(fields) {}
+
+    BoatStatus status(size_t boat) const { return fields_.status(boat); }
+    int sysid(size_t boat) const { return fields_.sysid(boat); }
+
+    /**
+     * 两船都匹配到航线时按航线判断；否则简化为同一航线方向的船只认为在同一航线上
+     */
+    bool isOnSameRoute(size_t i, size_t j) const {
+        int route_i = fields_.route(i);
+        int route_j = fields_.route(j);
+        if (route_i >= 0 && route_j >= 0) return route_i == route_j;
+        return fields_.routeDirection(i) == fields_.routeDirection(j);
+    }
+
+    /**
+     * 出坞/入坞船只是否需要考虑对方船只：本船不在任何船坞通道内，
+     * 或对方位于本船通道内、在告警时域内驶入本船通道
+     */
+    bool isCorridorRelevant(size_t self, size_t other) const {
+        int dock = fields_.dock(self);
+        if (dock == DockCorridorIndex::kNoDock) return true;
+        return fields_.detector.dock_index_.reaches(dock, fields_.x(other), fields_.y(other),
+                                                    fields_.vx(other), fields_.vy(other),
+                                                    fields_.corridorHorizon());
+    }
+
+    /**
+     * 第j条船是否为第i条船的前船：同一航线上为弧长方向最近的前方船只(弯曲航线上同样成立)，
+     * 否则为航向前方45度范围内的船只
+     */
+    bool isAhead(size_t i, size_t j) const {
+        int route_i = fields_.route(i);
+        if (route_i >= 0 && route_i == fields_.route(j)) {
+            return fields_.aheadOnRoute(i) == static_cast<int>(j);
+        }
+        return isAheadOfHeading(fields_.x(j) - fields_.x(i), fields_.y(j) - fields_.y(i),
+                                fields_.hx(i), fields_.hy(i));
+    }
+
+    bool isOncomingTraffic(size_t i, size_t j) const {
+        return isOncomingHeading(fields_.routeDirection(i), fields_.routeDirection(j),
+                                 fields_.heading(i), fields_.heading(j));
+    }
+
+protected:
+    Fields fields_;
+};
+
+/**
+ * 检测规则的累加接口：规则只能写入本船(self)的告警槽位
+ */
+template <typename Fields>
+class CollisionDetector::BasicRuleContext : public BasicRuleView<Fields> {
+public:
+    explicit BasicRuleContext(const Fields& fields) : BasicRuleView<Fields>(fields) {}
+
+    /**
+     * 碰撞时间早于槽位已记录的碰撞时间时记录(含预计碰撞位置)并返回true
+     */
+    bool record(AlertSlot slot, size_t self, double collision_time) {
+        AlertAccumulator& acc = fields().accumulator(slot, self);
+        if (!(collision_time < acc.min_collision_time)) return false;
+        fields().detector.recordCollision(acc, fields().x(self), fields().y(self),
+                                          fields().vx(self), fields().vy(self), collision_time);
+        return true;
+    }
+
+    /**
+     * 按碰撞时间(含滞回)设置槽位告警等级
+     */
+    void updateLevel(AlertSlot slot, size_t self, double collision_time) {
+        AlertAccumulator& acc = fields().accumulator(slot, self);
+        acc.alert.level = fields().detector.calculateAlertLevel(collision_time, acc.previous_level);
+    }
+
+    void addFrontBoat(AlertSlot slot, size_t self, size_t other) {
+        fields().accumulator(slot, self).alert.front_boat_ids.push_back(fields().sysid(other));
+    }
+
+    void addOncomingBoat(AlertSlot slot, size_t self, size_t other) {
+        AlertAccumulator& acc = fields().accumulator(slot, self);
+        acc.alert.oncoming_boat_ids.push_back(fields().sysid(other));
+        acc.alert.other_heading = fields().heading(other);
+    }
+
+    /**
+     * 设置跟随告警报告的最近前船
+     */
+    void setClosestFrontBoat(size_t self, size_t other) {
+        fields().accumulator(AlertSlot::PRIMARY, self).closest_front_boat = fields().sysid(other);
+    }
+
+private:
+    const Fields& fields() const { return this->fields_; }
+};
+
+inline CollisionDetector::RuleView CollisionDetector::ruleView() const {
+    return RuleView(FleetFields{*this, nullptr, nullptr});
+}
+
+inline CollisionDetector::RuleContext CollisionDetector::ruleContext() {
+    return RuleContext(FleetFields{*this, primary_accumulators_.data(), oncoming_accumulators_.data()});
+}
+
+} // namespace boat_pro
+
+#endif
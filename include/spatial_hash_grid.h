@@ -0,0 +1,83 @@
+// ==================== include/spatial_hash_grid.h ====================
+#ifndef BOAT_PRO_SPATIAL_HASH_GRID_H
+#define BOAT_PRO_SPATIAL_HASH_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 均匀网格空间哈希
+ * 在局部平面坐标(米)中按固定边长划分网格，用于快速枚举相邻单元内的候选对象
+ */
+class SpatialHashGrid {
+public:
+    SpatialHashGrid();
+
+    /**
+     * 清空并按新的单元边长重建网格
+     * @param cell_size 网格边长(米)
+     * @param ids 对象ID列表
+     * @param xs 对象东向坐标(米)
+     * @param ys 对象北向坐标(米)
+     */
+    void rebuild(double cell_size, const std::vector<int>& ids,
+                 const std::vector<double>& xs, const std::vector<double>& ys);
+
+    /**
+     * 以数组下标作为对象ID重建网格
+     */
+    void rebuild(double cell_size, const std::vector<double>& xs, const std::vector<double>& ys);
+
+    /**
+     * 清空网格
+     */
+    void clear();
+
+    /**
+     * 查询给定位置所在单元及其周围8个单元内的所有对象ID(追加到out)
+     */
+    void queryNeighbors(double x, double y, std::vector<int>& out) const;
+
+    /**
+     * 查询与给定位置距离可能不超过range的所有单元内的对象ID(追加到out)
+     * range不超过单元边长时等价于queryNeighbors
+     */
+    void queryRange(double x, double y, double range, std::vector<int>& out) const;
+
+    double getCellSize() const { return cell_size_; }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        int id;
+    };
+
+    /**
+     * 非空单元在entries_中的区间[begin, end)，end为0表示空槽
+     */
+    struct Cell {
+        uint64_t key;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    double cell_size_;
+    std::vector<Entry> entries_;  // 按单元键排序的对象
+    std::vector<Cell> cells_;     // 开放寻址哈希表(线性探测)，容量为2的幂
+    int cell_shift_;              // 哈希值右移位数，64 - log2(容量)
+    std::vector<int> index_ids_;  // 以下标作为ID重建时复用的ID数组
+
+    int32_t cellCoord(double v) const;
+    static uint64_t cellKey(int32_t cx, int32_t cy);
+    const Cell* findCell(uint64_t key) const;
+    void insertCell(uint64_t key, uint32_t begin, uint32_t end);
+};
+
+} // namespace boat_pro
+
+#endif
@@ -0,0 +1,70 @@
+// ==================== include/thread_pool.h ====================
+#ifndef BOAT_PRO_THREAD_POOL_H
+#define BOAT_PRO_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace boat_pro {
+
+/**
+ * 可复用的工作窃取线程池
+ * 每个工作者维护自己的任务队列，空闲时从其他队列尾部窃取任务；
+ * 调用 parallelFor 的线程作为0号工作者参与执行
+ */
+class WorkStealingThreadPool {
+public:
+    using TaskFunction = std::function<void(size_t task, size_t worker)>;
+
+    /**
+     * @param worker_count 工作者总数(含调用线程)，至少为1
+     */
+    explicit WorkStealingThreadPool(size_t worker_count);
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    size_t getWorkerCount() const { return queues_.size(); }
+
+    /**
+     * 并行执行 task_count 个任务，返回时所有任务均已完成
+     * @param fn 任务函数，参数为任务下标和执行该任务的工作者下标
+     */
+    void parallelFor(size_t task_count, const TaskFunction& fn);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex dispatch_mutex_;  // 同一时刻只允许一批任务
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const TaskFunction* current_fn_;
+    uint64_t generation_;
+    size_t active_workers_;
+    bool stopping_;
+    std::atomic<size_t> remaining_tasks_;
+
+    void workerLoop(size_t worker);
+    void runTasks(size_t worker, const TaskFunction& fn);
+    bool popTask(size_t worker, size_t& task);
+};
+
+} // namespace boat_pro
+
+#endif
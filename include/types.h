@@ -3,6 +3,10 @@
 #define BOAT_PRO_TYPES_H
 
 #include <jsoncpp/json/json.h>  // jsoncpp header
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
 #include <vector>
 #include <string>
 #include <memory>
@@ -29,6 +33,22 @@ enum class AlertLevel {
     EMERGENCY = 2  // 紧急
 };
 
+// 告警类型
+enum class AlertType : int {
+    UNDOCKING = 1,  // 出坞
+    DOCKING = 2,    // 入坞
+    FOLLOWING = 3,  // 跟随
+    ONCOMING = 4    // 对向
+};
+
+// 告警变化事件
+enum class AlertEvent : int {
+    NEW = 1,          // 新告警
+    ESCALATED = 2,    // 等级升高
+    DEESCALATED = 3,  // 等级降低
+    CLEARED = 4       // 告警解除
+};
+
 // 地理坐标点
 struct GeoPoint {
     double lat;  // 纬度
@@ -58,6 +78,59 @@ struct BoatState {
     GeoPoint getPosition() const { return GeoPoint(lat, lng); }
 };
 
+/**
+ * 紧凑定点船只记录(不超过32字节)
+ * 经纬度按1e-7度定点存储(与DroneIDLocationMessage一致，约1厘米)，航向按0.01度、
+ * 速度按0.01 m/s定点存储，状态与航线方向合并为一个字节。
+ * 用于船只状态的存储与传递：状态存储发布的快照、碰撞检测器的船只状态表及分区副本都保存此格式，
+ * 整体复制与逐条比较的开销较小。检测遍历不直接读取此格式，而是读取船队变化时由其重建的
+ * BoatSnapshot结构数组。与BoatState的转换误差不超过半个定点单位
+ */
+struct PackedBoatState {
+    static constexpr double kDegreeScale = 1e7;   // 经纬度：1e-7度
+    static constexpr double kHeadingScale = 100;  // 航向：0.01度
+    static constexpr double kSpeedScale = 100;    // 速度：0.01 m/s
+
+    double timestamp;
+    int32_t sysid;
+    int32_t lat_e7;
+    int32_t lng_e7;
+    uint16_t heading_cdeg;  // [0, 36000)
+    int16_t speed_cms;
+    uint8_t flags;          // 低2位航行状态，第2-3位航线方向
+
+    static PackedBoatState pack(const BoatState& boat);
+    BoatState unpack() const;
+
+    double getLat() const { return lat_e7 / kDegreeScale; }
+    double getLng() const { return lng_e7 / kDegreeScale; }
+    double getHeading() const { return heading_cdeg / kHeadingScale; }
+    double getSpeed() const { return speed_cms / kSpeedScale; }
+    BoatStatus getStatus() const { return static_cast<BoatStatus>(flags & 0x3); }
+    RouteDirection getRouteDirection() const { return static_cast<RouteDirection>((flags >> 2) & 0x3); }
+    GeoPoint getPosition() const { return GeoPoint(getLat(), getLng()); }
+
+    /**
+     * 位置、运动与状态字段是否相同(不比较时间戳)
+     */
+    bool isSameMotionState(const PackedBoatState& other) const {
+        return lat_e7 == other.lat_e7 && lng_e7 == other.lng_e7 &&
+               heading_cdeg == other.heading_cdeg && speed_cms == other.speed_cms &&
+               flags == other.flags;
+    }
+};
+static_assert(sizeof(PackedBoatState) <= 32, "PackedBoatState应不超过32字节");
+
+/**
+ * 打包船只状态并按ID升序排列，ID重复时保留最后一条
+ */
+std::vector<PackedBoatState> packBoatStates(const std::vector<BoatState>& boats);
+
+/**
+ * 在按ID升序排列的记录中查找船只，不存在时返回nullptr
+ */
+const PackedBoatState* findPackedBoat(const std::vector<PackedBoatState>& boats, int sysid);
+
 // 船坞静态数据
 struct DockInfo {
     int dock_id;
@@ -90,6 +163,11 @@ struct SystemConfig {
     double warning_threshold_s;    // 警告判断时间阈值(秒)
     int max_boats;                 // 最大船只数量
     double min_route_gap_m;        // 最小航线横向间距
+    int detection_threads;         // 碰撞检测线程数，0表示使用硬件并发数
+    double alert_hysteresis_s;     // 告警等级回落所需的碰撞时间滞回量(秒)
+    double dock_corridor_radius_m; // 船坞进出通道半径(米)，不大于0时出坞/入坞检查不限通道
+    int detection_shards;          // 地理分片数，大于1时每个分片由独立的检测器检测
+    bool fast_trig;                // 船坞推荐的距离排序与模拟器位置推进使用快速近似三角函数(误差在毫米量级)
     
     Json::Value toJson() const;
     static SystemConfig fromJson(const Json::Value& json);
@@ -97,17 +175,97 @@ struct SystemConfig {
     static SystemConfig getDefault();
 };
 
+/**
+ * 船只ID列表
+ * 告警通常只涉及一到两条船，不超过内联容量时不分配堆内存；
+ * 超出后转存到堆上，clear()保留已分配容量供复用
+ */
+class BoatIdList {
+public:
+    static constexpr size_t kInlineCapacity = 2;
+    
+    BoatIdList() = default;
+    BoatIdList(std::initializer_list<int> ids);
+    BoatIdList(const std::vector<int>& ids);
+    
+    void push_back(int id);
+    void clear();
+    
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const int* data() const { return size_ <= kInlineCapacity ? inline_ids_ : overflow_.data(); }
+    const int* begin() const { return data(); }
+    const int* end() const { return data() + size_; }
+    int operator[](size_t index) const { return data()[index]; }
+    
+    std::vector<int> toVector() const { return std::vector<int>(begin(), end()); }
+    
+    friend bool operator==(const BoatIdList& a, const BoatIdList& b);
+    friend bool operator==(const BoatIdList& a, const std::vector<int>& b);
+    friend bool operator!=(const BoatIdList& a, const BoatIdList& b) { return !(a == b); }
+    
+private:
+    size_t size_ = 0;
+    int inline_ids_[kInlineCapacity] = {};
+    std::vector<int> overflow_;  // 超出内联容量时存放全部ID
+};
+
+/**
+ * 驻留字符串
+ * 相同内容的字符串全局只保存一份，对象本身只是指向该份的指针，复制不分配内存，
+ * 相等比较只需比较指针。驻留的字符串在程序运行期间一直有效
+ */
+class InternedString {
+public:
+    InternedString();
+    InternedString(const std::string& text);
+    InternedString(const char* text);
+    
+    const std::string& str() const { return *text_; }
+    const char* c_str() const { return text_->c_str(); }
+    bool empty() const { return text_->empty(); }
+    void clear();
+    
+    operator const std::string&() const { return *text_; }
+    
+    friend bool operator==(const InternedString& a, const InternedString& b) {
+        return a.text_ == b.text_;
+    }
+    friend bool operator!=(const InternedString& a, const InternedString& b) {
+        return a.text_ != b.text_;
+    }
+    friend std::ostream& operator<<(std::ostream& os, const InternedString& text) {
+        return os << *text.text_;
+    }
+    
+private:
+    const std::string* text_;
+    
+    static const std::string* intern(const std::string& text);
+};
+
 // 碰撞告警信息
 struct CollisionAlert {
     AlertLevel level;              // 紧急程度
     int current_boat_id;           // 当前船ID
-    std::vector<int> front_boat_ids;    // 前向被碰撞船ID列表
-    std::vector<int> oncoming_boat_ids; // 对向被碰撞船ID列表
+    BoatIdList front_boat_ids;     // 前向被碰撞船ID列表
+    BoatIdList oncoming_boat_ids;  // 对向被碰撞船ID列表
     GeoPoint collision_position;   // 预计碰撞位置
     double collision_time;         // 预计碰撞时间(秒)
     double current_heading;        // 当前船航向
     double other_heading;          // 对方船航向(对向碰撞时)
-    std::string decision_advice;   // 避碰决策建议
+    InternedString decision_advice;  // 避碰决策建议
+    AlertType type = AlertType::FOLLOWING;  // 告警类型
+    uint64_t alert_id = 0;         // 告警ID，同一船只同类告警持续期间保持不变
+    
+    Json::Value toJson() const;
+};
+
+// 告警变化
+struct AlertDelta {
+    AlertEvent event;              // 变化事件
+    AlertLevel previous_level;     // 变化前等级
+    CollisionAlert alert;          // 变化后的告警(解除时等级为NORMAL)
     
     Json::Value toJson() const;
 };
@@ -0,0 +1,106 @@
+// ==================== src/alert_table.cpp ====================
+#include "alert_table.h"
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace boat_pro {
+
+void AlertTable::load(const std::vector<CollisionAlert>& alerts) {
+    alerts_ = alerts;
+    tracked_.clear();
+    for (size_t k = 0; k < alerts_.size(); ++k) {
+        const CollisionAlert& alert = alerts_[k];
+        tracked_[alertKey(alert.current_boat_id, alert.type)] = TrackedAlert{alert.alert_id, k, pass_};
+    }
+}
+
+std::vector<AlertDelta> AlertTable::update(std::vector<CollisionAlert>& alerts) {
+    std::vector<AlertDelta> deltas;
+    ++pass_;
+
+    // 仍在告警表中的告警沿用原ID，只有等级变化才产生事件
+    for (size_t k = 0; k < alerts.size(); ++k) {
+        CollisionAlert& alert = alerts[k];
+        auto [it, inserted] = tracked_.try_emplace(alertKey(alert.current_boat_id, alert.type),
+                                                   TrackedAlert{0, 0, 0});
+        TrackedAlert& entry = it->second;
+        if (inserted) {
+            alert.alert_id = next_alert_id_++;
+            deltas.push_back({AlertEvent::NEW, AlertLevel::NORMAL, alert});
+        } else {
+            alert.alert_id = entry.alert_id;
+            AlertLevel previous = alerts_[entry.position].level;
+            if (alert.level > previous) {
+                deltas.push_back({AlertEvent::ESCALATED, previous, alert});
+            } else if (alert.level < previous) {
+                deltas.push_back({AlertEvent::DEESCALATED, previous, alert});
+            }
+        }
+        entry.alert_id = alert.alert_id;
+        entry.position = k;
+        entry.pass = pass_;
+    }
+
+    // 本次未出现的告警解除，按原告警表顺序输出
+    cleared_positions_.clear();
+    for (auto it = tracked_.begin(); it != tracked_.end();) {
+        if (it->second.pass == pass_) {
+            ++it;
+            continue;
+        }
+        cleared_positions_.push_back(it->second.position);
+        it = tracked_.erase(it);
+    }
+    std::sort(cleared_positions_.begin(), cleared_positions_.end());
+    for (size_t position : cleared_positions_) {
+        CollisionAlert alert = alerts_[position];
+        AlertLevel previous = alert.level;
+        alert.level = AlertLevel::NORMAL;
+        alert.decision_advice = decisionAdvice(alert);
+        deltas.push_back({AlertEvent::CLEARED, previous, alert});
+    }
+
+    alerts_.swap(alerts);
+    return deltas;
+}
+
+InternedString AlertTable::decisionAdvice(const CollisionAlert& alert) {
+    // 按(等级, 是否有前方船只, 是否有对向船只)预先驻留全部建议文本
+    static const auto advice_table = [] {
+        std::array<InternedString, 12> table;
+        for (int level = 0; level <= 2; ++level) {
+            for (int front = 0; front <= 1; ++front) {
+                for (int oncoming = 0; oncoming <= 1; ++oncoming) {
+                    std::string advice;
+                    switch (static_cast<AlertLevel>(level)) {
+                        case AlertLevel::EMERGENCY:
+                            advice = "紧急停船！";
+                            break;
+                        case AlertLevel::WARNING:
+                            if (oncoming) advice += "对向来船，建议减速并向右避让；";
+                            if (front) advice += "前方有船，建议减速或停船等待；";
+                            break;
+                        case AlertLevel::NORMAL:
+                            advice = "保持正常航行；";
+                            break;
+                    }
+                    table[level * 4 + front * 2 + oncoming] = InternedString(advice);
+                }
+            }
+        }
+        return table;
+    }();
+
+    int level = static_cast<int>(alert.level);
+    int front = alert.front_boat_ids.empty() ? 0 : 1;
+    int oncoming = alert.oncoming_boat_ids.empty() ? 0 : 1;
+    return advice_table[level * 4 + front * 2 + oncoming];
+}
+
+uint64_t AlertTable::alertKey(int boat_id, AlertType type) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(boat_id)) << 8) |
+           static_cast<uint64_t>(static_cast<int>(type));
+}
+
+} // namespace boat_pro
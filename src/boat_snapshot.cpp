@@ -0,0 +1,150 @@
+// ==================== src/boat_snapshot.cpp ====================
+#include "boat_snapshot.h"
+#include "geometry_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace boat_pro {
+
+void BoatSnapshot::build(const std::map<int, BoatState>& boats, const GeoPoint& projection_origin) {
+    reset(projection_origin, boats.size());
+    for (const auto& [boat_id, boat] : boats) {
+        appendBoat(boat);
+    }
+}
+
+void BoatSnapshot::build(const std::vector<PackedBoatState>& boats, const GeoPoint& projection_origin) {
+    reset(projection_origin, boats.size());
+    for (const auto& boat : boats) {
+        appendBoat(boat.unpack());
+    }
+}
+
+size_t BoatSnapshot::indexOf(int boat_id) const {
+    auto it = std::lower_bound(sysid.begin(), sysid.end(), boat_id);
+    if (it == sysid.end() || *it != boat_id) return size();
+    return static_cast<size_t>(it - sysid.begin());
+}
+
+void BoatSnapshot::reset(const GeoPoint& projection_origin, size_t count) {
+    clear();
+
+    // 缩放系数只在原点处计算一次
+    origin = projection_origin;
+    projector.recenter(origin);
+
+    sysid.reserve(count);
+    x.reserve(count);
+    y.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    hx.reserve(count);
+    hy.reserve(count);
+    status.reserve(count);
+    route_direction.reserve(count);
+    lat.reserve(count);
+    lng.reserve(count);
+    heading.reserve(count);
+    speed.reserve(count);
+    timestamp.reserve(count);
+    report_x.reserve(count);
+    report_y.reserve(count);
+}
+
+void BoatSnapshot::appendBoat(const BoatState& boat) {
+    size_t count = size() + 1;
+    sysid.resize(count);
+    x.resize(count);
+    y.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    hx.resize(count);
+    hy.resize(count);
+    status.resize(count);
+    route_direction.resize(count);
+    lat.resize(count);
+    lng.resize(count);
+    heading.resize(count);
+    speed.resize(count);
+    timestamp.resize(count);
+    report_x.resize(count);
+    report_y.resize(count);
+    setBoat(count - 1, boat);
+}
+
+void BoatSnapshot::setBoat(size_t i, const BoatState& boat) {
+    double px, py;
+    project(boat.lat, boat.lng, px, py);
+
+    // 航向0度为正北，顺时针增加；三角函数每船每次更新只计算一次
+    double heading_rad = geometry::toRadians(boat.heading);
+    double heading_x = std::sin(heading_rad);
+    double heading_y = std::cos(heading_rad);
+
+    sysid[i] = boat.sysid;
+    x[i] = px;
+    y[i] = py;
+    vx[i] = boat.speed * heading_x;
+    vy[i] = boat.speed * heading_y;
+    hx[i] = heading_x;
+    hy[i] = heading_y;
+    status[i] = boat.status;
+    route_direction[i] = boat.route_direction;
+    lat[i] = boat.lat;
+    lng[i] = boat.lng;
+    heading[i] = boat.heading;
+    speed[i] = boat.speed;
+    timestamp[i] = boat.timestamp;
+    report_x[i] = px;
+    report_y[i] = py;
+}
+
+void BoatSnapshot::clear() {
+    sysid.clear();
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    hx.clear();
+    hy.clear();
+    status.clear();
+    route_direction.clear();
+    lat.clear();
+    lng.clear();
+    heading.clear();
+    speed.clear();
+    timestamp.clear();
+    report_x.clear();
+    report_y.clear();
+}
+
+void BoatSnapshot::advanceTo(double time) {
+    for (size_t i = 0; i < x.size(); ++i) {
+        double elapsed = time - timestamp[i];
+        x[i] = report_x[i] + vx[i] * elapsed;
+        y[i] = report_y[i] + vy[i] * elapsed;
+    }
+}
+
+void BoatSnapshot::restoreReportedPositions() {
+    x = report_x;
+    y = report_y;
+}
+
+double BoatSnapshot::maxSpeed() const {
+    double max_speed = 0.0;
+    for (double s : speed) {
+        max_speed = std::max(max_speed, std::abs(s));
+    }
+    return max_speed;
+}
+
+double BoatSnapshot::maxOffset() const {
+    double max_offset = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        max_offset = std::max(max_offset, std::max(std::abs(x[i]), std::abs(y[i])));
+    }
+    return max_offset;
+}
+
+} // namespace boat_pro
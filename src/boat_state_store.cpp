@@ -0,0 +1,92 @@
+// ==================== src/boat_state_store.cpp ====================
+#include "boat_state_store.h"
+#include <algorithm>
+
+namespace boat_pro {
+
+BoatStateStore::BoatStateStore()
+    : published_(std::make_shared<FleetSnapshot>()) {
+}
+
+void BoatStateStore::update(const BoatState& boat) {
+    PackedBoatState packed = PackedBoatState::pack(boat);
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    pending_.push_back(packed);
+}
+
+void BoatStateStore::applyBatch(const std::vector<BoatState>& boats) {
+    std::vector<PackedBoatState> packed;
+    packed.reserve(boats.size());
+    for (const auto& boat : boats) {
+        packed.push_back(PackedBoatState::pack(boat));
+    }
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    pending_.insert(pending_.end(), packed.begin(), packed.end());
+    mergePending();
+}
+
+void BoatStateStore::replace(const std::vector<BoatState>& boats) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+
+    pending_.clear();
+    auto next = std::make_shared<FleetSnapshot>();
+    next->boats = packBoatStates(boats);
+    publish(std::move(next));
+}
+
+bool BoatStateStore::flush() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    if (pending_.empty()) return false;
+    mergePending();
+    return true;
+}
+
+size_t BoatStateStore::pendingCount() const {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return pending_.size();
+}
+
+void BoatStateStore::mergePending() {
+    // 暂存更新按ID稳定排序，同一ID保留最后到达的一条
+    std::stable_sort(pending_.begin(), pending_.end(),
+                     [](const PackedBoatState& a, const PackedBoatState& b) { return a.sysid < b.sysid; });
+    size_t kept = 0;
+    for (size_t k = 0; k < pending_.size(); ++k) {
+        if (kept > 0 && pending_[kept - 1].sysid == pending_[k].sysid) {
+            pending_[kept - 1] = pending_[k];
+        } else {
+            pending_[kept++] = pending_[k];
+        }
+    }
+    pending_.resize(kept);
+
+    // 与当前快照(按ID升序)一次归并到新副本，已发布的快照保持不变
+    SnapshotPtr published = load();
+    const std::vector<PackedBoatState>& current = published->boats;
+    auto next = std::make_shared<FleetSnapshot>();
+    next->boats.reserve(current.size() + pending_.size());
+    size_t i = 0, j = 0;
+    while (i < current.size() || j < pending_.size()) {
+        if (j == pending_.size() || (i < current.size() && current[i].sysid < pending_[j].sysid)) {
+            next->boats.push_back(current[i++]);
+        } else {
+            if (i < current.size() && current[i].sysid == pending_[j].sysid) ++i;
+            next->boats.push_back(pending_[j++]);
+        }
+    }
+    pending_.clear();
+    publish(std::move(next));
+}
+
+BoatStateStore::SnapshotPtr BoatStateStore::load() const {
+    return std::atomic_load_explicit(&published_, std::memory_order_acquire);
+}
+
+void BoatStateStore::publish(std::shared_ptr<FleetSnapshot> next) {
+    next->version = load()->version + 1;
+    std::atomic_store_explicit(&published_, SnapshotPtr(std::move(next)),
+                               std::memory_order_release);
+}
+
+} // namespace boat_pro
@@ -1,338 +1,900 @@
 // ==================== src/collision_detector.cpp ====================
 #include "collision_detector.h"
+#include "detection_rules.h"
 #include "geometry_utils.h"
+#include "collision_kernel.h"
 #include <algorithm>
-#include <sstream>
+#include <cmath>
+#include <limits>
+#include <thread>
 
 namespace boat_pro {
 
 CollisionDetector::CollisionDetector(const SystemConfig& config) 
-    : config_(config) {
+    : config_(config), recheck_(config), kinetic_(config) {
+    setThreadCount(config.detection_threads);
+    setRules<rules::DefaultRules>();
 }
 
 void CollisionDetector::updateBoatStates(const std::vector<BoatState>& boats) {
-    boat_states_.clear();
-    for (const auto& boat : boats) {
-        boat_states_[boat.sysid] = boat;
+    updateBoatStates(packBoatStates(boats));
+}
+
+void CollisionDetector::updateBoatStates(const std::map<int, BoatState>& boats) {
+    std::vector<PackedBoatState> next_states;
+    next_states.reserve(boats.size());
+    for (const auto& [boat_id, boat] : boats) {
+        next_states.push_back(PackedBoatState::pack(boat));
+    }
+    updateBoatStates(next_states);
+}
+
+void CollisionDetector::updateBoatStates(const std::vector<PackedBoatState>& next_states) {
+    // 新旧状态表均按ID升序，归并比较找出新增、变化和移除的船只；
+    // 检测只依赖位置、运动与状态字段，时间戳变化不需要重算
+    size_t old_index = 0;
+    for (const auto& boat : next_states) {
+        while (old_index < boat_states_.size() && boat_states_[old_index].sysid < boat.sysid) {
+            kinetic_.forget(boat_states_[old_index++].sysid);
+        }
+        bool existing = old_index < boat_states_.size() && boat_states_[old_index].sysid == boat.sysid;
+        if (!existing) {
+            kinetic_.markMembershipChanged();
+        }
+        if (!existing || !boat_states_[old_index].isSameMotionState(boat)) {
+            pair_cache_.markDirty(boat.sysid);
+            kinetic_.markChanged(boat.sysid);
+        }
+        if (existing) ++old_index;
+    }
+    // 离开的船只不再保留版本记录
+    for (; old_index < boat_states_.size(); ++old_index) {
+        kinetic_.forget(boat_states_[old_index].sysid);
+    }
+    
+    boat_states_ = next_states;
+    snapshot_stale_ = true;
+}
+
+void CollisionDetector::updateBoatState(const BoatState& boat) {
+    PackedBoatState packed = PackedBoatState::pack(boat);
+    auto it = std::lower_bound(boat_states_.begin(), boat_states_.end(), packed.sysid,
+                               [](const PackedBoatState& b, int id) { return b.sysid < id; });
+    if (it != boat_states_.end() && it->sysid == packed.sysid) {
+        *it = packed;
+    } else {
+        kinetic_.markMembershipChanged();
+        boat_states_.insert(it, packed);
     }
+    pair_cache_.markDirty(boat.sysid);
+    kinetic_.markChanged(boat.sysid);
+    snapshot_stale_ = true;
+}
+
+void CollisionDetector::setBroadPhaseEnabled(bool enabled) {
+    broad_phase_enabled_ = enabled;
+}
+
+bool CollisionDetector::isBroadPhaseEnabled() const {
+    return broad_phase_enabled_;
+}
+
+void CollisionDetector::setIncrementalEnabled(bool enabled, int full_revalidation_ticks) {
+    pair_cache_.configure(enabled, full_revalidation_ticks);
+}
+
+bool CollisionDetector::isIncrementalEnabled() const {
+    return pair_cache_.isEnabled();
+}
+
+void CollisionDetector::setAdaptiveRecheckEnabled(bool enabled, double max_interval_s) {
+    recheck_.configure(enabled, max_interval_s);
+}
+
+bool CollisionDetector::isAdaptiveRecheckEnabled() const {
+    return recheck_.isEnabled();
+}
+
+void CollisionDetector::setThreadCount(int threads) {
+    size_t count = threads > 0 ? static_cast<size_t>(threads)
+                               : std::max(1u, std::thread::hardware_concurrency());
+    if (count == thread_count_) return;
+    
+    // 线程池在第一次并行检测时才创建
+    thread_count_ = count;
+    thread_pool_.reset();
+}
+
+WorkStealingThreadPool* CollisionDetector::acquireThreadPool(size_t boat_count) {
+    if (thread_count_ <= 1 || boat_count < kMinParallelBoats) return nullptr;
+    if (!thread_pool_) {
+        thread_pool_ = std::make_unique<WorkStealingThreadPool>(thread_count_);
+    }
+    return thread_pool_.get();
+}
+
+size_t CollisionDetector::getThreadCount() const {
+    return thread_count_;
+}
+
+const DetectionStats& CollisionDetector::getLastStats() const {
+    return last_stats_;
+}
+
+size_t CollisionDetector::getTrackedVersionCount() const {
+    return kinetic_.getTrackedVersionCount();
 }
 
 void CollisionDetector::setDockInfo(const std::vector<DockInfo>& docks) {
-    dock_info_ = docks;
+    dock_index_.setDocks(docks);
+    route_index_stale_ = true;
 }
 
 void CollisionDetector::setRouteInfo(const std::vector<RouteInfo>& routes) {
-    route_info_ = routes;
+    route_index_.setRoutes(routes);
+    route_index_stale_ = true;
 }
 
 std::vector<CollisionAlert> CollisionDetector::detectCollisions() {
-    std::vector<CollisionAlert> alerts;
+    return detectCollisionsInPlace();
+}
+
+void CollisionDetector::prepareSnapshot() {
+    refreshSnapshot();
+    if (snapshot_advanced_) {
+        snapshot_.restoreReportedPositions();
+        snapshot_advanced_ = false;
+        route_index_stale_ = true;
+    }
+    refreshRouteIndex();
+}
+
+const std::vector<CollisionAlert>& CollisionDetector::detectCollisionsInPlace() {
+    prepareSnapshot();
     
-    // 检测各类型碰撞
-    auto undocking_alerts = detectUndockingCollisions();
-    auto docking_alerts = detectDockingCollisions();
-    auto following_alerts = detectFollowingCollisions();
-    auto oncoming_alerts = detectOncomingCollisions();
+    size_t boat_count = snapshot_.size();
+    last_stats_ = DetectionStats();
+    last_stats_.boat_count = boat_count;
+    last_stats_.full_revalidation = pair_cache_.beginPass();
+    last_stats_.max_speed = max_boat_speed_;
+    last_stats_.covered_horizon_s = getAlertHorizon();
     
-    // 合并所有告警
-    alerts.insert(alerts.end(), undocking_alerts.begin(), undocking_alerts.end());
-    alerts.insert(alerts.end(), docking_alerts.begin(), docking_alerts.end());
-    alerts.insert(alerts.end(), following_alerts.begin(), following_alerts.end());
-    alerts.insert(alerts.end(), oncoming_alerts.begin(), oncoming_alerts.end());
+    if (recheck_.isEnabled()) recheck_.advanceClock(snapshot_.timestamp);
+    resetAccumulators();
     
-    return alerts;
+    // 按(i, j)字典序枚举每个无序船对一次：对任一船只而言，
+    // 对方船只仍按ID升序到达，与逐船遍历的累加顺序一致。
+    // 多线程时按连续船只区间划分任务，各任务输出独立缓冲区，再按任务顺序合并
+    size_t chunk_count = 1;
+    if (WorkStealingThreadPool* pool = acquireThreadPool(boat_count)) {
+        chunk_count = (boat_count + kBoatsPerTask - 1) / kBoatsPerTask;
+        chunks_.resize(chunk_count);
+        scratches_.resize(pool->getWorkerCount());
+        pool->parallelFor(chunk_count, [this, boat_count](size_t task, size_t worker) {
+            size_t begin = task * kBoatsPerTask;
+            size_t end = std::min(boat_count, begin + kBoatsPerTask);
+            chunks_[task].reset();
+            evaluateBoatRange(begin, end, scratches_[worker], chunks_[task]);
+        });
+    } else {
+        chunks_.resize(1);
+        scratches_.resize(1);
+        chunks_[0].reset();
+        evaluateBoatRange(0, boat_count, scratches_[0], chunks_[0]);
+    }
+    
+    mergeChunks(chunk_count);
+    pair_cache_.endPass();
+    
+    collectAlerts();
+    return alert_arena_;
 }
 
-std::vector<CollisionAlert> CollisionDetector::detectUndockingCollisions() {
-    std::vector<CollisionAlert> alerts;
+std::vector<CollisionAlert> CollisionDetector::detectCollisions(
+    std::chrono::steady_clock::duration budget) {
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    prepareSnapshot();
     
-    // 查找所有出坞状态的船只
-    for (const auto& [boat_id, boat] : boat_states_) {
-        if (boat.status != BoatStatus::UNDOCKING) continue;
-        
-        CollisionAlert alert;
-        alert.current_boat_id = boat_id;
-        alert.current_heading = boat.heading;
-        alert.level = AlertLevel::NORMAL;
-        
-        double min_collision_time = std::numeric_limits<double>::max();
-        GeoPoint predicted_collision_pos;
-        
-        // 检查与其他船只的碰撞风险
-        for (const auto& [other_id, other_boat] : boat_states_) {
-            if (other_id == boat_id) continue;
-            
-            // 计算碰撞时间
-            GeoPoint boat_vel = geometry::calculateDestination(
-                GeoPoint(0, 0), boat.heading, boat.speed);
-            GeoPoint other_vel = geometry::calculateDestination(
-                GeoPoint(0, 0), other_boat.heading, other_boat.speed);
-                
-            double collision_time = geometry::calculateCollisionTime(
-                boat.getPosition(), boat_vel,
-                other_boat.getPosition(), other_vel,
-                getCollisionRadius()
-            );
-            
-            if (collision_time > 0 && collision_time < min_collision_time) {
-                min_collision_time = collision_time;
-                
-                // 计算碰撞位置
-                predicted_collision_pos = geometry::calculateDestination(
-                    boat.getPosition(), boat.heading, boat.speed * collision_time);
-                
-                // 根据优先级判断
-                if (other_boat.status == BoatStatus::DOCKING ||
-                    other_boat.status == BoatStatus::NORMAL_SAIL) {
-                    alert.level = calculateAlertLevel(collision_time);
-                    
-                    if (isOncomingTraffic(boat, other_boat)) {
-                        alert.oncoming_boat_ids.push_back(other_id);
-                        alert.other_heading = other_boat.heading;
-                    } else {
-                        alert.front_boat_ids.push_back(other_id);
-                    }
-                }
+    size_t boat_count = snapshot_.size();
+    last_stats_ = DetectionStats();
+    last_stats_.boat_count = boat_count;
+    last_stats_.max_speed = max_boat_speed_;
+    
+    resetAccumulators();
+    
+    // 按连续船只区间分段枚举船对，紧急类船对在枚举时直接求解；
+    // 每段开始前检查时钟，预算用完后只枚举紧急距离内的船对
+    size_t task_count = std::max<size_t>(1, (boat_count + kBoatsPerTask - 1) / kBoatsPerTask);
+    chunks_.resize(std::max(task_count, chunks_.size()));
+    auto enumerate = [this, boat_count, deadline](size_t task, size_t worker) {
+        size_t begin = task * kBoatsPerTask;
+        size_t end = std::min(boat_count, begin + kBoatsPerTask);
+        bool urgent_only = std::chrono::steady_clock::now() >= deadline;
+        chunks_[task].reset();
+        prioritizeBoatRange(begin, end, urgent_only, scratches_[worker], chunks_[task]);
+    };
+    WorkStealingThreadPool* pool = acquireThreadPool(boat_count);
+    if (pool) {
+        scratches_.resize(std::max(scratches_.size(), pool->getWorkerCount()));
+        pool->parallelFor(task_count, enumerate);
+    } else {
+        scratches_.resize(std::max<size_t>(1, scratches_.size()));
+        for (size_t task = 0; task < task_count; ++task) enumerate(task, 0);
+    }
+    
+    // 其余船对按下界从小到大分批取出，每批开始前检查时钟；多线程时一批分给各工作者并行求解
+    budget_queue_.clear();
+    budget_records_.clear();
+    bool urgent_only = false;
+    for (size_t task = 0; task < task_count; ++task) {
+        const PairChunk& chunk = chunks_[task];
+        last_stats_.candidate_pairs += chunk.candidate_pairs;
+        last_stats_.pruned_pairs += chunk.pruned_pairs;
+        last_stats_.corridor_pairs += chunk.corridor_pairs;
+        last_stats_.solved_pairs += chunk.solved_pairs;
+        urgent_only = urgent_only || chunk.urgent_only;
+        budget_queue_.append(chunk.deferred);
+        budget_records_.insert(budget_records_.end(), chunk.records.begin(), chunk.records.end());
+    }
+    budget_queue_.heapify();
+    
+    size_t batch_size = kBudgetCheckInterval * (pool ? pool->getWorkerCount() : 1);
+    size_t evaluated = 0;
+    while (budget_queue_.remaining() > 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            last_stats_.budget_exhausted = true;
+            break;
+        }
+        budget_queue_.popBatch(batch_size, budget_batch_);
+        size_t count = budget_batch_.size();
+        budget_times_.resize(count);
+        auto solve = [this, count](size_t task, size_t) {
+            size_t begin = task * kBudgetCheckInterval;
+            size_t end = std::min(count, begin + kBudgetCheckInterval);
+            for (size_t k = begin; k < end; ++k) {
+                budget_times_[k] = solvePair(budget_batch_[k].i, budget_batch_[k].j);
             }
+        };
+        size_t solve_tasks = (count + kBudgetCheckInterval - 1) / kBudgetCheckInterval;
+        if (pool && solve_tasks > 1) {
+            pool->parallelFor(solve_tasks, solve);
+        } else {
+            for (size_t task = 0; task < solve_tasks; ++task) solve(task, 0);
         }
-        
-        if (alert.level != AlertLevel::NORMAL) {
-            alert.collision_time = min_collision_time;
-            alert.collision_position = predicted_collision_pos;
-            alert.decision_advice = generateDecisionAdvice(alert);
-            alerts.push_back(alert);
+        for (size_t k = 0; k < count; ++k) {
+            if (isAlertRelevant(budget_times_[k])) {
+                budget_records_.push_back({budget_batch_[k].i, budget_batch_[k].j, budget_times_[k]});
+            }
         }
+        evaluated += count;
     }
+    last_stats_.solved_pairs += evaluated;
+    last_stats_.deferred_pairs = budget_queue_.remaining();
     
-    return alerts;
+    // 未求解船对的碰撞时间不小于其下界；只枚举紧急距离的船只，
+    // 其余船对间距超过紧急距离，碰撞时间不小于紧急阈值
+    last_stats_.covered_horizon_s = getAlertHorizon();
+    if (budget_queue_.remaining() > 0) {
+        last_stats_.covered_horizon_s = std::min(last_stats_.covered_horizon_s,
+                                                 budget_queue_.nextLowerBound());
+    }
+    if (urgent_only) {
+        last_stats_.budget_exhausted = true;
+        last_stats_.covered_horizon_s = std::min(last_stats_.covered_horizon_s,
+                                                 config_.emergency_threshold_s);
+    }
+    
+    // 按(i, j)字典序归类，累加顺序与全量检测一致
+    std::sort(budget_records_.begin(), budget_records_.end(), [](const PairRecord& a, const PairRecord& b) {
+        return a.i < b.i || (a.i == b.i && a.j < b.j);
+    });
+    classifyRecords(budget_records_);
+    
+    // 本次未消化状态变化，也未更新缓存；增量模式下次全量重算
+    if (pair_cache_.isEnabled()) pair_cache_.requestFullPass();
+    
+    collectAlerts();
+    return alert_arena_;
 }
 
-std::vector<CollisionAlert> CollisionDetector::detectDockingCollisions() {
-    std::vector<CollisionAlert> alerts;
+std::vector<CollisionAlert> CollisionDetector::detectCollisionsAt(double now) {
+    refreshSnapshot();
+    
+    double time = kinetic_.begin(now, snapshot_.origin);
+    snapshot_.advanceTo(now);
+    snapshot_advanced_ = true;
+    route_index_stale_ = true;
+    refreshRouteIndex();
+    
+    last_stats_ = DetectionStats();
+    last_stats_.boat_count = snapshot_.size();
+    last_stats_.max_speed = max_boat_speed_;
+    kinetic_.update(snapshot_, time, max_boat_speed_, last_stats_);
+    
+    resetAccumulators();
+    
+    // 告警时间窗内的船对按ID字典序收集后归类，累加顺序与全量检测一致
+    chunks_.resize(std::max<size_t>(1, chunks_.size()));
+    PairChunk& out = chunks_[0];
+    out.reset();
+    kinetic_.collectWarningPairs(snapshot_, time, getAlertHorizon(), out.records);
+    classifyRecords(out.records);
+    
+    collectAlerts();
+    return alert_arena_;
+}
+
+std::vector<CollisionAlert> CollisionDetector::evaluateBoat(int boat_id) {
+    const PackedBoatState* boat = findPackedBoat(boat_states_, boat_id);
+    if (!boat) return {};
+    return evaluateBoat(boat_id, boat->unpack());
+}
+
+std::vector<CollisionAlert> CollisionDetector::evaluateBoat(int boat_id, const BoatState& hypothetical_state) {
+    prepareSnapshot();
+    if (snapshot_.empty()) return {};
+    return evaluateProbe(boat_id, hypothetical_state);
+}
+
+std::vector<CollisionAlert> CollisionDetector::evaluateProbe(int boat_id,
+                                                             const BoatState& hypothetical_state) const {
+    // 假设状态与船队状态同样按紧凑记录的精度取整，平面字段与BoatSnapshot::setBoat算法相同
+    BoatState boat = hypothetical_state;
+    boat.sysid = boat_id;
+    boat = PackedBoatState::pack(boat).unpack();
+    
+    size_t fleet_size = snapshot_.size();
+    size_t order = static_cast<size_t>(
+        std::lower_bound(snapshot_.sysid.begin(), snapshot_.sysid.end(), boat_id) - snapshot_.sysid.begin());
+    bool existing = order < fleet_size && snapshot_.sysid[order] == boat_id;
+    
+    ProbeBoat probe;
+    probe.index = fleet_size;
+    probe.fleet_index = existing ? order : fleet_size;
+    probe.sysid = boat_id;
+    snapshot_.project(boat.lat, boat.lng, probe.x, probe.y);
+    double heading_rad = geometry::toRadians(boat.heading);
+    probe.hx = std::sin(heading_rad);
+    probe.hy = std::cos(heading_rad);
+    probe.vx = boat.speed * probe.hx;
+    probe.vy = boat.speed * probe.hy;
+    probe.heading = boat.heading;
+    probe.speed = boat.speed;
+    probe.status = boat.status;
+    probe.route_direction = boat.route_direction;
+    probe.dock = dock_index_.empty() ? DockCorridorIndex::kNoDock : dock_index_.locate(probe.x, probe.y);
+    
+    // 航线匹配与前船：只定位假设船只，在共享索引中按(弧长, 下标)次序查找前船，
+    // 跳过本船在索引中的旧位置
+    probe.route = -1;
+    probe.arc = 0.0;
+    probe.ahead = RouteIndex::kNoBoat;
+    if (!route_index_.empty() &&
+        route_index_.locate(probe.x, probe.y, probe.hx, probe.hy, probe.route_direction,
+                            config_.min_route_gap_m, probe.route, probe.arc)) {
+        probe.ahead = route_index_.nearestAheadAt(probe.route, probe.arc, order, probe.fleet_index);
+    } else {
+        probe.route = -1;
+    }
+    probe.primary.reset(boat_id, probe.heading, primaryAlertType(probe.status));
+    probe.oncoming.reset(boat_id, probe.heading, AlertType::ONCOMING);
+    
+    // 候选船只：假设速度可能超过建网格时的最大船速，按实际距离界扩大查询范围，
+    // 范围覆盖的单元数超过船只数时退回逐船检查。
+    // 通道内的出坞/入坞船只只查询船坞周围可能在告警时域内驶入通道的船只。
+    // 查询不包含滞回，告警时域为告警阈值
+    double horizon = config_.warning_threshold_s;
+    ProbeView view(ProbeFields{*this, probe});
+    std::vector<int> candidates;
+    bool corridor_only = probe.status != BoatStatus::NORMAL_SAIL && probe.dock != DockCorridorIndex::kNoDock;
+    double center_x = probe.x;
+    double center_y = probe.y;
+    double range = (std::abs(probe.speed) + max_boat_speed_) * horizon + getCollisionRadius();
+    if (corridor_only) {
+        center_x = dock_index_.getDockX(probe.dock);
+        center_y = dock_index_.getDockY(probe.dock);
+        range = dock_index_.getRadius() + max_boat_speed_ * horizon;
+    }
+    double rings = std::ceil(range * detection::kGridRangeMargin / grid_.getCellSize());
+    if (!broad_phase_enabled_ || (2 * rings + 1) * (2 * rings + 1) > static_cast<double>(fleet_size)) {
+        for (size_t j = 0; j < fleet_size; ++j) candidates.push_back(static_cast<int>(j));
+    } else {
+        grid_.queryRange(center_x, center_y, range * detection::kGridRangeMargin, candidates);
+        std::sort(candidates.begin(), candidates.end());
+    }
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](int j) {
+                         size_t other = static_cast<size_t>(j);
+                         return other == probe.fleet_index ||
+                                (corridor_only && !view.isCorridorRelevant(probe.index, other));
+                     }),
+                     candidates.end());
+    
+    size_t count = candidates.size();
+    std::vector<double> batch_x(count), batch_y(count), batch_vx(count), batch_vy(count);
+    std::vector<double> times(count);
+    for (size_t k = 0; k < count; ++k) {
+        size_t j = static_cast<size_t>(candidates[k]);
+        batch_x[k] = snapshot_.x[j];
+        batch_y[k] = snapshot_.y[j];
+        batch_vx[k] = snapshot_.vx[j];
+        batch_vy[k] = snapshot_.vy[j];
+    }
+    geometry::calculateCollisionTimes(probe.x, probe.y, probe.vx, probe.vy,
+                                      batch_x.data(), batch_y.data(), batch_vx.data(), batch_vy.data(),
+                                      count, getCollisionRadius(), times.data());
+    
+    // 只从本船视角归类，对方船只按ID升序到达，与全量检测的累加顺序一致
+    (this->*rules_->classify_probe)(probe, candidates, times);
+    return collectBoatAlerts(probe.status, probe.primary, probe.oncoming);
+}
+
+void CollisionDetector::AlertAccumulator::reset(int boat_id, double heading, AlertType type) {
+    alert.level = AlertLevel::NORMAL;
+    alert.type = type;
+    alert.alert_id = 0;
+    alert.current_boat_id = boat_id;
+    alert.current_heading = heading;
+    alert.front_boat_ids.clear();
+    alert.oncoming_boat_ids.clear();
+    alert.collision_position = GeoPoint();
+    alert.collision_time = 0.0;
+    alert.other_heading = 0.0;
+    alert.decision_advice.clear();
+    min_collision_time = std::numeric_limits<double>::max();
+    closest_front_boat = -1;
+    previous_level = AlertLevel::NORMAL;
+}
+
+void CollisionDetector::resetAccumulators() {
+    size_t boat_count = snapshot_.size();
+    primary_accumulators_.resize(boat_count);
+    oncoming_accumulators_.resize(boat_count);
+    for (size_t i = 0; i < boat_count; ++i) {
+        primary_accumulators_[i].reset(snapshot_.sysid[i], snapshot_.heading[i],
+                                       primaryAlertType(snapshot_.status[i]));
+        oncoming_accumulators_[i].reset(snapshot_.sysid[i], snapshot_.heading[i],
+                                        AlertType::ONCOMING);
+    }
+    
+    if (!tracking_pass_) return;
+    for (const CollisionAlert& alert : alert_table_.getAlerts()) {
+        size_t i = snapshot_.indexOf(alert.current_boat_id);
+        if (i >= boat_count) continue;
+        AlertAccumulator& acc = alert.type == AlertType::ONCOMING ? oncoming_accumulators_[i]
+                                                                   : primary_accumulators_[i];
+        if (acc.alert.type == alert.type) acc.previous_level = alert.level;
+    }
+}
+
+std::vector<AlertDelta> CollisionDetector::detectAlertChanges() {
+    tracking_pass_ = true;
+    detectCollisionsInPlace();
+    tracking_pass_ = false;
+    return alert_table_.update(alert_arena_);
+}
+
+std::vector<AlertDelta> CollisionDetector::detectAlertChangesAt(double now) {
+    tracking_pass_ = true;
+    detectCollisionsAt(now);
+    tracking_pass_ = false;
+    return alert_table_.update(alert_arena_);
+}
+
+const std::vector<CollisionAlert>& CollisionDetector::getCurrentAlerts() const {
+    return alert_table_.getAlerts();
+}
+
+void CollisionDetector::loadAlertTable(const std::vector<CollisionAlert>& alerts) {
+    alert_table_.load(alerts);
+}
+
+void CollisionDetector::setProjectionOrigin(const GeoPoint& origin) {
+    if (has_projection_origin_ && projection_origin_.lat == origin.lat &&
+        projection_origin_.lng == origin.lng) {
+        return;
+    }
+    projection_origin_ = origin;
+    has_projection_origin_ = true;
+    snapshot_stale_ = true;
+    pair_cache_.requestFullPass();
+    kinetic_.markMembershipChanged();
+}
+
+AlertType CollisionDetector::primaryAlertType(BoatStatus status) {
+    switch (status) {
+        case BoatStatus::UNDOCKING:
+            return AlertType::UNDOCKING;
+        case BoatStatus::DOCKING:
+            return AlertType::DOCKING;
+        case BoatStatus::NORMAL_SAIL:
+            break;
+    }
+    return AlertType::FOLLOWING;
+}
+
+void CollisionDetector::PairChunk::reset() {
+    records.clear();
+    cache_updates.clear();
+    recheck_updates.clear();
+    deferred.clear();
+    urgent_only = false;
+    candidate_pairs = 0;
+    pruned_pairs = 0;
+    solved_pairs = 0;
+    cached_pairs = 0;
+    corridor_pairs = 0;
+    scheduled_pairs = 0;
+}
+
+void CollisionDetector::evaluateBoatRange(size_t begin, size_t end, PairScratch& scratch,
+                                          PairChunk& out) const {
+    (this->*rules_->evaluate_range)(begin, end, scratch, out);
+}
+
+void CollisionDetector::prioritizeBoatRange(size_t begin, size_t end, bool urgent_only,
+                                            PairScratch& scratch, PairChunk& out) const {
+    (this->*rules_->prioritize_range)(begin, end, urgent_only, scratch, out);
+}
+
+double CollisionDetector::solvePair(size_t i, size_t j) const {
+    const BoatSnapshot& snap = snapshot_;
+    double collision_time;
+    geometry::calculateCollisionTimes(snap.x[i], snap.y[i], snap.vx[i], snap.vy[i],
+                                      &snap.x[j], &snap.y[j], &snap.vx[j], &snap.vy[j],
+                                      1, getCollisionRadius(), &collision_time);
+    return collision_time;
+}
+
+void CollisionDetector::evaluateCandidates(size_t i, PairScratch& scratch, PairChunk& out) const {
+    const std::vector<int>& candidates = scratch.candidates;
+    const std::vector<uint8_t>& corridor_skipped = scratch.corridor_skipped;
+    size_t count = candidates.size();
+    if (count == 0) return;
+    
+    const BoatSnapshot& snap = snapshot_;
+    std::vector<double>& times = scratch.batch_times;
+    std::vector<size_t>& solve_slots = scratch.solve_slots;
+    times.resize(count);
+    out.candidate_pairs += count;
     
-    // 查找所有入坞状态的船只
-    for (const auto& [boat_id, boat] : boat_states_) {
-        if (boat.status != BoatStatus::DOCKING) continue;
+    // 运动学剪枝：两船间距超过 (|v1|+|v2|)*T + R 时，告警时域内不可能进入碰撞半径，
+    // 只需一次平方距离比较即可排除，无需开方或求解
+    // 增量模式：双方状态都未变化的船对直接复用缓存结果
+    // 自适应复查：计划未到期的船对在告警时域内不可能成为告警，跳过求解
+    solve_slots.clear();
+    bool use_cache = pair_cache_.isReusable();
+    bool use_schedule = recheck_.isActive();
+    size_t pruned = 0;
+    size_t corridor = 0;
+    size_t scheduled = 0;
+    for (size_t k = 0; k < count; ++k) {
+        size_t j = static_cast<size_t>(candidates[k]);
         
-        CollisionAlert alert;
-        alert.current_boat_id = boat_id;
-        alert.current_heading = boat.heading;
-        alert.level = AlertLevel::NORMAL;
+        if (isPrunedByReach(i, j)) {
+            times[k] = -1;
+            ++pruned;
+            continue;
+        }
         
-        double min_collision_time = std::numeric_limits<double>::max();
-        GeoPoint predicted_collision_pos;
+        if (!corridor_skipped.empty() && corridor_skipped[k]) {
+            times[k] = -1;
+            ++corridor;
+            continue;
+        }
         
-        // 检查与跟随船只的碰撞风险
-        for (const auto& [other_id, other_boat] : boat_states_) {
-            if (other_id == boat_id) continue;
-            
-            // 入坞船只具有最高优先级，其他船只需要避让
-            if (isOnSameRoute(boat, other_boat)) {
-                // 计算碰撞时间
-                GeoPoint boat_vel = geometry::calculateDestination(
-                    GeoPoint(0, 0), boat.heading, boat.speed);
-                GeoPoint other_vel = geometry::calculateDestination(
-                    GeoPoint(0, 0), other_boat.heading, other_boat.speed);
-                    
-                double collision_time = geometry::calculateCollisionTime(
-                    boat.getPosition(), boat_vel,
-                    other_boat.getPosition(), other_vel,
-                    getCollisionRadius()
-                );
-                
-                if (collision_time > 0 && collision_time < min_collision_time) {
-                    min_collision_time = collision_time;
-                    alert.level = calculateAlertLevel(collision_time);
-                    alert.front_boat_ids.push_back(other_id);
-                    
-                    // 计算碰撞位置
-                    predicted_collision_pos = geometry::calculateDestination(
-                        boat.getPosition(), boat.heading, boat.speed * collision_time);
-                }
-            }
+        if (use_schedule && recheck_.isDeferred(pairKey(i, j), snap, i, j)) {
+            times[k] = -1;
+            ++scheduled;
+            continue;
         }
         
-        if (alert.level != AlertLevel::NORMAL) {
-            alert.collision_time = min_collision_time;
-            alert.collision_position = predicted_collision_pos;
-            alert.decision_advice = generateDecisionAdvice(alert);
-            alerts.push_back(alert);
+        if (use_cache && pair_cache_.lookup(i, j, pairKey(i, j), times[k])) continue;
+        solve_slots.push_back(k);
+    }
+    
+    size_t solve_count = solve_slots.size();
+    out.pruned_pairs += pruned;
+    out.corridor_pairs += corridor;
+    out.scheduled_pairs += scheduled;
+    out.solved_pairs += solve_count;
+    out.cached_pairs += count - pruned - corridor - scheduled - solve_count;
+    
+    // 全部需要求解且下标连续时(如暴力遍历)直接使用快照数组，否则先收集到暂存数组
+    size_t first = static_cast<size_t>(candidates.front());
+    if (solve_count == count && static_cast<size_t>(candidates.back()) - first + 1 == count) {
+        geometry::calculateCollisionTimes(
+            snap.x[i], snap.y[i], snap.vx[i], snap.vy[i],
+            snap.x.data() + first, snap.y.data() + first,
+            snap.vx.data() + first, snap.vy.data() + first,
+            count, getCollisionRadius(), times.data());
+    } else if (solve_count > 0) {
+        scratch.batch_x.resize(solve_count);
+        scratch.batch_y.resize(solve_count);
+        scratch.batch_vx.resize(solve_count);
+        scratch.batch_vy.resize(solve_count);
+        scratch.solved_times.resize(solve_count);
+        for (size_t s = 0; s < solve_count; ++s) {
+            size_t j = static_cast<size_t>(candidates[solve_slots[s]]);
+            scratch.batch_x[s] = snap.x[j];
+            scratch.batch_y[s] = snap.y[j];
+            scratch.batch_vx[s] = snap.vx[j];
+            scratch.batch_vy[s] = snap.vy[j];
+        }
+        geometry::calculateCollisionTimes(
+            snap.x[i], snap.y[i], snap.vx[i], snap.vy[i],
+            scratch.batch_x.data(), scratch.batch_y.data(),
+            scratch.batch_vx.data(), scratch.batch_vy.data(),
+            solve_count, getCollisionRadius(), scratch.solved_times.data());
+        for (size_t s = 0; s < solve_count; ++s) {
+            times[solve_slots[s]] = scratch.solved_times[s];
         }
     }
     
-    return alerts;
+    // 缓存写回推迟到合并阶段，避免并发修改
+    if (pair_cache_.isEnabled()) {
+        for (size_t s = 0; s < solve_count; ++s) {
+            size_t k = solve_slots[s];
+            out.cache_updates.emplace_back(pairKey(i, static_cast<size_t>(candidates[k])), times[k]);
+        }
+    }
+    
+    // 复查计划同样在合并阶段写回
+    if (recheck_.isEnabled()) {
+        RecheckSchedule::Entry entry;
+        for (size_t s = 0; s < solve_count; ++s) {
+            size_t j = static_cast<size_t>(candidates[solve_slots[s]]);
+            if (recheck_.plan(snap, i, j, isAlertRelevant(times[solve_slots[s]]), entry)) {
+                out.recheck_updates.emplace_back(pairKey(i, j), entry);
+            }
+        }
+    }
+    
+    for (size_t k = 0; k < count; ++k) {
+        if (!isAlertRelevant(times[k])) continue;
+        out.records.push_back({static_cast<uint32_t>(i),
+                               static_cast<uint32_t>(candidates[k]), times[k]});
+    }
 }
 
-std::vector<CollisionAlert> CollisionDetector::detectFollowingCollisions() {
-    std::vector<CollisionAlert> alerts;
-    
-    // 查找所有正常航行状态的船只
-    for (const auto& [boat_id, boat] : boat_states_) {
-        if (boat.status != BoatStatus::NORMAL_SAIL) continue;
-        
-        CollisionAlert alert;
-        alert.current_boat_id = boat_id;
-        alert.current_heading = boat.heading;
-        alert.level = AlertLevel::NORMAL;
+void CollisionDetector::mergeChunks(size_t chunk_count) {
+    for (size_t c = 0; c < chunk_count; ++c) {
+        const PairChunk& chunk = chunks_[c];
+        last_stats_.candidate_pairs += chunk.candidate_pairs;
+        last_stats_.pruned_pairs += chunk.pruned_pairs;
+        last_stats_.solved_pairs += chunk.solved_pairs;
+        last_stats_.cached_pairs += chunk.cached_pairs;
+        last_stats_.corridor_pairs += chunk.corridor_pairs;
+        last_stats_.scheduled_pairs += chunk.scheduled_pairs;
         
-        double min_collision_time = std::numeric_limits<double>::max();
-        GeoPoint predicted_collision_pos;
-        int closest_front_boat = -1;
-        
-        // 检查与同航线前方船只的碰撞风险
-        for (const auto& [other_id, other_boat] : boat_states_) {
-            if (other_id == boat_id) continue;
-            
-            if (isOnSameRoute(boat, other_boat) && !isOncomingTraffic(boat, other_boat)) {
-                // 判断是否为前方船只
-                double bearing_to_other = geometry::calculateBearing(
-                    boat.getPosition(), other_boat.getPosition());
-                double heading_diff = geometry::angleDifference(boat.heading, bearing_to_other);
-                
-                if (heading_diff < 45.0) { // 前方45度范围内
-                    // 计算碰撞时间
-                    GeoPoint boat_vel = geometry::calculateDestination(
-                        GeoPoint(0, 0), boat.heading, boat.speed);
-                    GeoPoint other_vel = geometry::calculateDestination(
-                        GeoPoint(0, 0), other_boat.heading, other_boat.speed);
-                        
-                    double collision_time = geometry::calculateCollisionTime(
-                        boat.getPosition(), boat_vel,
-                        other_boat.getPosition(), other_vel,
-                        getCollisionRadius()
-                    );
-                    
-                    if (collision_time > 0 && collision_time < min_collision_time) {
-                        min_collision_time = collision_time;
-                        closest_front_boat = other_id;
-                        
-                        // 计算碰撞位置
-                        predicted_collision_pos = geometry::calculateDestination(
-                            boat.getPosition(), boat.heading, boat.speed * collision_time);
-                        
-                        alert.level = calculateAlertLevel(collision_time);
-                    }
-                }
-            }
+        for (const auto& [key, collision_time] : chunk.cache_updates) {
+            pair_cache_.store(key, collision_time);
         }
         
-        if (alert.level != AlertLevel::NORMAL && closest_front_boat != -1) {
-            alert.front_boat_ids.push_back(closest_front_boat);
-            alert.collision_time = min_collision_time;
-            alert.collision_position = predicted_collision_pos;
-            alert.decision_advice = generateDecisionAdvice(alert);
-            alerts.push_back(alert);
+        for (const auto& [key, entry] : chunk.recheck_updates) {
+            recheck_.apply(key, entry);
         }
+        
+        classifyRecords(chunk.records);
     }
+}
+
+void CollisionDetector::classifyRecords(const std::vector<PairRecord>& records) {
+    (this->*rules_->classify_records)(records.data(), records.data() + records.size());
+}
+
+bool CollisionDetector::isOnlyHysteresisRelevant(size_t self, double collision_time) const {
+    // 滞回区间内的船对只用于维持本船已有的告警
+    return collision_time > config_.warning_threshold_s &&
+           primary_accumulators_[self].previous_level == AlertLevel::NORMAL &&
+           oncoming_accumulators_[self].previous_level == AlertLevel::NORMAL;
+}
+
+void CollisionDetector::recordCollision(AlertAccumulator& acc, double x, double y, double vx, double vy,
+                                        double collision_time) const {
+    acc.min_collision_time = collision_time;
     
-    return alerts;
+    // 碰撞位置：在局部平面上按本船速度线性外推后反投影
+    acc.alert.collision_position = snapshot_.unproject(x + vx * collision_time, y + vy * collision_time);
 }
 
-std::vector<CollisionAlert> CollisionDetector::detectOncomingCollisions() {
-    std::vector<CollisionAlert> alerts;
+void CollisionDetector::emitAlert(AlertAccumulator& acc, std::vector<CollisionAlert>& alerts) const {
+    acc.alert.collision_time = acc.min_collision_time;
+    acc.alert.decision_advice = AlertTable::decisionAdvice(acc.alert);
+    alerts.push_back(acc.alert);
+}
+
+void CollisionDetector::collectAlerts() {
+    std::vector<CollisionAlert>& alerts = alert_arena_;
+    alerts.clear();
     
-    // 查找所有正常航行状态的船只
-    for (const auto& [boat_id, boat] : boat_states_) {
-        if (boat.status != BoatStatus::NORMAL_SAIL) continue;
-        
-        CollisionAlert alert;
-        alert.current_boat_id = boat_id;
-        alert.current_heading = boat.heading;
-        alert.level = AlertLevel::NORMAL;
-        
-        double min_collision_time = std::numeric_limits<double>::max();
-        GeoPoint predicted_collision_pos;
-        
-        // 检查与对向船只的碰撞风险
-        for (const auto& [other_id, other_boat] : boat_states_) {
-            if (other_id == boat_id) continue;
-            
-            if (isOncomingTraffic(boat, other_boat)) {
-                // 计算碰撞时间
-                GeoPoint boat_vel = geometry::calculateDestination(
-                    GeoPoint(0, 0), boat.heading, boat.speed);
-                GeoPoint other_vel = geometry::calculateDestination(
-                    GeoPoint(0, 0), other_boat.heading, other_boat.speed);
-                    
-                double collision_time = geometry::calculateCollisionTime(
-                    boat.getPosition(), boat_vel,
-                    other_boat.getPosition(), other_vel,
-                    getCollisionRadius()
-                );
-                
-                if (collision_time > 0 && collision_time < min_collision_time) {
-                    min_collision_time = collision_time;
-                    alert.level = calculateAlertLevel(collision_time);
-                    alert.oncoming_boat_ids.push_back(other_id);
-                    alert.other_heading = other_boat.heading;
-                    
-                    // 计算碰撞位置
-                    predicted_collision_pos = geometry::calculateDestination(
-                        boat.getPosition(), boat.heading, boat.speed * collision_time);
-                }
+    auto emit = [&](AlertAccumulator& acc) {
+        emitAlert(acc, alerts);
+    };
+    
+    // 出坞、入坞告警
+    for (BoatStatus status : {BoatStatus::UNDOCKING, BoatStatus::DOCKING}) {
+        for (size_t i = 0; i < snapshot_.size(); ++i) {
+            if (snapshot_.status[i] != status) continue;
+            if (primary_accumulators_[i].alert.level != AlertLevel::NORMAL) {
+                emit(primary_accumulators_[i]);
             }
         }
-        
-        if (alert.level != AlertLevel::NORMAL) {
-            alert.collision_time = min_collision_time;
-            alert.collision_position = predicted_collision_pos;
-            alert.decision_advice = generateDecisionAdvice(alert);
-            alerts.push_back(alert);
+    }
+    
+    // 跟随告警：只报告最近的前方船只
+    for (size_t i = 0; i < snapshot_.size(); ++i) {
+        AlertAccumulator& acc = primary_accumulators_[i];
+        if (snapshot_.status[i] != BoatStatus::NORMAL_SAIL) continue;
+        if (acc.alert.level != AlertLevel::NORMAL && acc.closest_front_boat != -1) {
+            acc.alert.front_boat_ids.push_back(acc.closest_front_boat);
+            emit(acc);
+        }
+    }
+    
+    // 对向告警
+    for (size_t i = 0; i < snapshot_.size(); ++i) {
+        if (snapshot_.status[i] != BoatStatus::NORMAL_SAIL) continue;
+        if (oncoming_accumulators_[i].alert.level != AlertLevel::NORMAL) {
+            emit(oncoming_accumulators_[i]);
         }
     }
+}
+
+std::vector<CollisionAlert> CollisionDetector::collectBoatAlerts(BoatStatus status, AlertAccumulator& primary,
+                                                                AlertAccumulator& oncoming) const {
+    std::vector<CollisionAlert> alerts;
+    
+    if (status != BoatStatus::NORMAL_SAIL) {
+        if (primary.alert.level != AlertLevel::NORMAL) emitAlert(primary, alerts);
+        return alerts;
+    }
     
+    if (primary.alert.level != AlertLevel::NORMAL && primary.closest_front_boat != -1) {
+        primary.alert.front_boat_ids.push_back(primary.closest_front_boat);
+        emitAlert(primary, alerts);
+    }
+    if (oncoming.alert.level != AlertLevel::NORMAL) {
+        emitAlert(oncoming, alerts);
+    }
     return alerts;
 }
 
-AlertLevel CollisionDetector::calculateAlertLevel(double collision_time) const {
-    if (collision_time <= config_.emergency_threshold_s) {
+AlertLevel CollisionDetector::calculateAlertLevel(double collision_time,
+                                                  AlertLevel previous_level) const {
+    double hysteresis = std::max(0.0, config_.alert_hysteresis_s);
+    if (collision_time <= config_.emergency_threshold_s ||
+        (previous_level == AlertLevel::EMERGENCY &&
+         collision_time <= config_.emergency_threshold_s + hysteresis)) {
         return AlertLevel::EMERGENCY;
-    } else if (collision_time <= config_.warning_threshold_s) {
+    } else if (collision_time <= config_.warning_threshold_s ||
+               (previous_level != AlertLevel::NORMAL &&
+                collision_time <= config_.warning_threshold_s + hysteresis)) {
         return AlertLevel::WARNING;
     }
     return AlertLevel::NORMAL;
 }
 
-std::string CollisionDetector::generateDecisionAdvice(const CollisionAlert& alert) const {
-    std::stringstream advice;
+double CollisionDetector::getAlertHorizon() const {
+    return tracking_pass_ ? getMaxAlertHorizon() : config_.warning_threshold_s;
+}
+
+double CollisionDetector::getMaxAlertHorizon() const {
+    return detection::maxAlertHorizon(config_);
+}
+
+bool CollisionDetector::isAlertRelevant(double collision_time) const {
+    // 超出告警时域的碰撞时间不会产生告警，也不计入告警中的船只列表
+    return collision_time > 0 && collision_time <= getAlertHorizon();
+}
+
+double CollisionDetector::getBroadPhaseRange() const {
+    // 按包含滞回量的最长告警时域建网格，跟踪与非跟踪检测共用
+    return getInteractionRange(config_, max_boat_speed_);
+}
+
+double CollisionDetector::getInteractionRange(const SystemConfig& config, double max_speed) {
+    // 告警时域内两船最多相互接近 (|v1| + |v2|) * T，再加上碰撞半径
+    return 2.0 * max_speed * detection::maxAlertHorizon(config) + detection::collisionRadius(config);
+}
+
+void CollisionDetector::refreshSnapshot() {
+    if (!snapshot_stale_) return;
+    snapshot_stale_ = false;
+    snapshot_advanced_ = false;
+    route_index_stale_ = true;
     
-    switch (alert.level) {
-        case AlertLevel::EMERGENCY:
-            advice << "紧急停船！";
-            break;
-        case AlertLevel::WARNING:
-            if (!alert.oncoming_boat_ids.empty()) {
-                advice << "对向来船，建议减速并向右避让；";
-            }
-            if (!alert.front_boat_ids.empty()) {
-                advice << "前方有船，建议减速或停船等待；";
-            }
-            break;
-        case AlertLevel::NORMAL:
-            advice << "保持正常航行；";
-            break;
+    // 投影原点固定不变，使未变化船只的坐标在多次重建间保持一致；
+    // 船队远离原点时重新选取原点，并全量重算
+    if (!has_projection_origin_ && !boat_states_.empty()) {
+        projection_origin_ = boat_states_.front().getPosition();
+        has_projection_origin_ = true;
     }
+    snapshot_.build(boat_states_, projection_origin_);
+    if (snapshot_.maxOffset() > kMaxOriginOffset) {
+        projection_origin_ = boat_states_.front().getPosition();
+        snapshot_.build(boat_states_, projection_origin_);
+        pair_cache_.requestFullPass();
+    }
+    pair_cache_.mapDirty(snapshot_.sysid);
+    
+    max_boat_speed_ = snapshot_.maxSpeed();
+    
+    // 网格边长不小于候选距离，保证只需查询相邻3x3单元；留出投影误差余量
+    double cell_size = getBroadPhaseRange() * detection::kGridRangeMargin + detection::kGridMinCellSize;
+    grid_.rebuild(cell_size, snapshot_.x, snapshot_.y);
+}
+
+void CollisionDetector::refreshRouteIndex() {
+    if (!route_index_stale_) return;
+    route_index_stale_ = false;
     
-    return advice.str();
+    // 距航线超过最小航线间距的船只视为不在航线上
+    route_index_.build(snapshot_, config_.min_route_gap_m);
+    dock_index_.build(snapshot_, config_.dock_corridor_radius_m);
+}
+
+uint64_t CollisionDetector::pairKey(size_t i, size_t j) const {
+    return detection::pairKey(snapshot_.sysid[i], snapshot_.sysid[j]);
+}
+
+void CollisionDetector::collectCandidates(size_t i, std::vector<int>& out) const {
+    out.clear();
+    
+    if (!broad_phase_enabled_) {
+        // 暴力遍历：保留用于结果校验
+        for (size_t j = i + 1; j < snapshot_.size(); ++j) {
+            out.push_back(static_cast<int>(j));
+        }
+        return;
+    }
+    
+    grid_.queryNeighbors(snapshot_.x[i], snapshot_.y[i], out);
+    
+    // 只保留下标大于i的船只，使每个无序船对只出现一次，并按ID升序访问
+    out.erase(std::remove_if(out.begin(), out.end(),
+                             [i](int j) { return static_cast<size_t>(j) <= i; }),
+              out.end());
+    std::sort(out.begin(), out.end());
 }
 
 double CollisionDetector::getCollisionRadius() const {
-    // 安全距离设为船只长度的2倍
-    return config_.boat.length * 2.0;
+    return detection::collisionRadius(config_);
+}
+
+bool CollisionDetector::isPrunedByReach(size_t i, size_t j) const {
+    // 只需一次平方距离比较即可排除，无需开方或求解
+    const BoatSnapshot& snap = snapshot_;
+    double dx = snap.x[j] - snap.x[i];
+    double dy = snap.y[j] - snap.y[i];
+    double reach = (std::abs(snap.speed[i]) + std::abs(snap.speed[j])) *
+                   getAlertHorizon() + getCollisionRadius();
+    reach = reach * kPruneMargin + kPruneSlack;
+    return dx * dx + dy * dy > reach * reach;
+}
+
+double CollisionDetector::collisionTimeLowerBound(size_t i, size_t j) const {
+    const BoatSnapshot& snap = snapshot_;
+    double gap = std::hypot(snap.x[j] - snap.x[i], snap.y[j] - snap.y[i]) - getCollisionRadius();
+    if (gap <= 0) return 0.0;
+    double closing_speed = std::abs(snap.speed[i]) + std::abs(snap.speed[j]);
+    return closing_speed > 0 ? gap / closing_speed : std::numeric_limits<double>::infinity();
 }
 
-bool CollisionDetector::isOnSameRoute(const BoatState& boat1, const BoatState& boat2) const {
-    // 简化判断：同一航线方向的船只认为在同一航线上
-    return boat1.route_direction == boat2.route_direction;
+bool CollisionDetector::isAheadOfHeading(double dx, double dy, double hx, double hy) {
+    // 航向与指向对方的方位夹角小于45度，等价于 cos(夹角) > cos(45°)，
+    // 用航向单位向量与相对位置的点积判断，避免逐对计算方位角
+    double dot = dx * hx + dy * hy;
+    return dot > 0 && dot * dot > 0.5 * (dx * dx + dy * dy);
 }
 
-bool CollisionDetector::isOncomingTraffic(const BoatState& boat1, const BoatState& boat2) const {
+bool CollisionDetector::isOncomingHeading(RouteDirection direction_i, RouteDirection direction_j,
+                                          double heading_i, double heading_j) {
     // 对向交通：不同航线方向且航向差接近180度
-    if (boat1.route_direction == boat2.route_direction) {
+    if (direction_i == direction_j) {
         return false;
     }
     
-    double heading_diff = geometry::angleDifference(boat1.heading, boat2.heading);
+    double heading_diff = geometry::angleDifference(heading_i, heading_j);
     return heading_diff > 135.0 && heading_diff < 225.0; // 允许45度误差
 }
 
@@ -0,0 +1,274 @@
+// ==================== src/collision_kernel.cpp ====================
+#include "collision_kernel.h"
+#include "geometry_utils.h"
+#include <cmath>
+
+// 禁止编译器把乘法与加减融合为FMA，使各向量实现与标量实现的舍入一致
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BOAT_PRO_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define BOAT_PRO_KERNEL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace boat_pro {
+namespace geometry {
+
+namespace {
+
+// 各向量实现按与标量版本相同的运算顺序求解，标量版本未被融合乘加时结果逐位一致
+void collisionTimesScalar(double x0, double y0, double vx0, double vy0,
+                          const double* xs, const double* ys,
+                          const double* vxs, const double* vys,
+                          size_t begin, size_t count, double radius, double* out) {
+    for (size_t k = begin; k < count; ++k) {
+        out[k] = calculateCollisionTime(xs[k] - x0, ys[k] - y0,
+                                        vxs[k] - vx0, vys[k] - vy0, radius);
+    }
+}
+
+#if defined(BOAT_PRO_KERNEL_X86)
+
+__attribute__((target("avx2")))
+size_t collisionTimesAvx2(double x0, double y0, double vx0, double vy0,
+                          const double* xs, const double* ys,
+                          const double* vxs, const double* vys,
+                          size_t count, double radius, double* out) {
+    const __m256d px = _mm256_set1_pd(x0);
+    const __m256d py = _mm256_set1_pd(y0);
+    const __m256d pvx = _mm256_set1_pd(vx0);
+    const __m256d pvy = _mm256_set1_pd(vy0);
+    const __m256d r2 = _mm256_set1_pd(radius * radius);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d none = _mm256_set1_pd(-1.0);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + k), px);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + k), py);
+        __m256d dvx = _mm256_sub_pd(_mm256_loadu_pd(vxs + k), pvx);
+        __m256d dvy = _mm256_sub_pd(_mm256_loadu_pd(vys + k), pvy);
+
+        __m256d a = _mm256_add_pd(_mm256_mul_pd(dvx, dvx), _mm256_mul_pd(dvy, dvy));
+        __m256d b = _mm256_mul_pd(two, _mm256_add_pd(_mm256_mul_pd(dx, dvx), _mm256_mul_pd(dy, dvy)));
+        __m256d c = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), r2);
+
+        __m256d disc = _mm256_sub_pd(_mm256_mul_pd(b, b), _mm256_mul_pd(_mm256_mul_pd(four, a), c));
+        __m256d invalid = _mm256_or_pd(_mm256_cmp_pd(disc, zero, _CMP_LT_OQ),
+                                       _mm256_cmp_pd(a, zero, _CMP_EQ_OQ));
+
+        __m256d root = _mm256_sqrt_pd(_mm256_max_pd(disc, zero));
+        __m256d denom = _mm256_mul_pd(two, a);
+        __m256d neg_b = _mm256_xor_pd(b, sign);
+        __m256d t1 = _mm256_div_pd(_mm256_sub_pd(neg_b, root), denom);
+        __m256d t2 = _mm256_div_pd(_mm256_add_pd(neg_b, root), denom);
+
+        // 取最小的正值时间，否则为-1
+        __m256d result = _mm256_blendv_pd(none, t2, _mm256_cmp_pd(t2, zero, _CMP_GT_OQ));
+        result = _mm256_blendv_pd(result, t1, _mm256_cmp_pd(t1, zero, _CMP_GT_OQ));
+        result = _mm256_blendv_pd(result, none, invalid);
+        _mm256_storeu_pd(out + k, result);
+    }
+    return k;
+}
+
+// GCC 12 的 avx512fintrin.h 在内联时会误报 -Wmaybe-uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+size_t collisionTimesAvx512(double x0, double y0, double vx0, double vy0,
+                            const double* xs, const double* ys,
+                            const double* vxs, const double* vys,
+                            size_t count, double radius, double* out) {
+    const __m512d px = _mm512_set1_pd(x0);
+    const __m512d py = _mm512_set1_pd(y0);
+    const __m512d pvx = _mm512_set1_pd(vx0);
+    const __m512d pvy = _mm512_set1_pd(vy0);
+    const __m512d r2 = _mm512_set1_pd(radius * radius);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d four = _mm512_set1_pd(4.0);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d none = _mm512_set1_pd(-1.0);
+
+    size_t k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(xs + k), px);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ys + k), py);
+        __m512d dvx = _mm512_sub_pd(_mm512_loadu_pd(vxs + k), pvx);
+        __m512d dvy = _mm512_sub_pd(_mm512_loadu_pd(vys + k), pvy);
+
+        __m512d a = _mm512_add_pd(_mm512_mul_pd(dvx, dvx), _mm512_mul_pd(dvy, dvy));
+        __m512d b = _mm512_mul_pd(two, _mm512_add_pd(_mm512_mul_pd(dx, dvx), _mm512_mul_pd(dy, dvy)));
+        __m512d c = _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), r2);
+
+        __m512d disc = _mm512_sub_pd(_mm512_mul_pd(b, b), _mm512_mul_pd(_mm512_mul_pd(four, a), c));
+        __mmask8 invalid = _mm512_cmp_pd_mask(disc, zero, _CMP_LT_OQ) |
+                           _mm512_cmp_pd_mask(a, zero, _CMP_EQ_OQ);
+
+        __m512d root = _mm512_sqrt_pd(_mm512_max_pd(disc, zero));
+        __m512d denom = _mm512_mul_pd(two, a);
+        __m512d neg_b = _mm512_castsi512_pd(_mm512_xor_si512(
+            _mm512_castpd_si512(b), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL))));
+        __m512d t1 = _mm512_div_pd(_mm512_sub_pd(neg_b, root), denom);
+        __m512d t2 = _mm512_div_pd(_mm512_add_pd(neg_b, root), denom);
+
+        // 取最小的正值时间，否则为-1
+        __m512d result = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(t2, zero, _CMP_GT_OQ), none, t2);
+        result = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(t1, zero, _CMP_GT_OQ), result, t1);
+        result = _mm512_mask_blend_pd(invalid, result, none);
+        _mm512_storeu_pd(out + k, result);
+    }
+    return k;
+}
+#pragma GCC diagnostic pop
+
+#endif // BOAT_PRO_KERNEL_X86
+
+#if defined(BOAT_PRO_KERNEL_NEON)
+
+size_t collisionTimesNeon(double x0, double y0, double vx0, double vy0,
+                          const double* xs, const double* ys,
+                          const double* vxs, const double* vys,
+                          size_t count, double radius, double* out) {
+    const float64x2_t px = vdupq_n_f64(x0);
+    const float64x2_t py = vdupq_n_f64(y0);
+    const float64x2_t pvx = vdupq_n_f64(vx0);
+    const float64x2_t pvy = vdupq_n_f64(vy0);
+    const float64x2_t r2 = vdupq_n_f64(radius * radius);
+    const float64x2_t two = vdupq_n_f64(2.0);
+    const float64x2_t four = vdupq_n_f64(4.0);
+    const float64x2_t zero = vdupq_n_f64(0.0);
+    const float64x2_t none = vdupq_n_f64(-1.0);
+
+    auto lanes = [&](size_t k) {
+        float64x2_t dx = vsubq_f64(vld1q_f64(xs + k), px);
+        float64x2_t dy = vsubq_f64(vld1q_f64(ys + k), py);
+        float64x2_t dvx = vsubq_f64(vld1q_f64(vxs + k), pvx);
+        float64x2_t dvy = vsubq_f64(vld1q_f64(vys + k), pvy);
+
+        float64x2_t a = vaddq_f64(vmulq_f64(dvx, dvx), vmulq_f64(dvy, dvy));
+        float64x2_t b = vmulq_f64(two, vaddq_f64(vmulq_f64(dx, dvx), vmulq_f64(dy, dvy)));
+        float64x2_t c = vsubq_f64(vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy)), r2);
+
+        float64x2_t disc = vsubq_f64(vmulq_f64(b, b), vmulq_f64(vmulq_f64(four, a), c));
+        uint64x2_t invalid = vorrq_u64(vcltq_f64(disc, zero), vceqq_f64(a, zero));
+
+        float64x2_t root = vsqrtq_f64(vmaxq_f64(disc, zero));
+        float64x2_t denom = vmulq_f64(two, a);
+        float64x2_t neg_b = vnegq_f64(b);
+        float64x2_t t1 = vdivq_f64(vsubq_f64(neg_b, root), denom);
+        float64x2_t t2 = vdivq_f64(vaddq_f64(neg_b, root), denom);
+
+        float64x2_t result = vbslq_f64(vcgtq_f64(t2, zero), t2, none);
+        result = vbslq_f64(vcgtq_f64(t1, zero), t1, result);
+        result = vbslq_f64(invalid, none, result);
+        vst1q_f64(out + k, result);
+    };
+
+    // 每次处理2x2路以掩盖除法和开方延迟
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        lanes(k);
+        lanes(k + 2);
+    }
+    for (; k + 2 <= count; k += 2) {
+        lanes(k);
+    }
+    return k;
+}
+
+#endif // BOAT_PRO_KERNEL_NEON
+
+SimdBackend probeSimdBackend() {
+#if defined(BOAT_PRO_KERNEL_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdBackend::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdBackend::AVX2;
+#endif
+#if defined(BOAT_PRO_KERNEL_NEON)
+    return SimdBackend::NEON;
+#endif
+    return SimdBackend::SCALAR;
+}
+
+bool isBackendSupported(SimdBackend backend) {
+    if (backend == SimdBackend::SCALAR) return true;
+    SimdBackend best = detectSimdBackend();
+    if (backend == SimdBackend::NEON) return best == SimdBackend::NEON;
+    if (backend == SimdBackend::AVX2) {
+        return best == SimdBackend::AVX2 || best == SimdBackend::AVX512;
+    }
+    return best == SimdBackend::AVX512;
+}
+
+} // namespace
+
+SimdBackend detectSimdBackend() {
+    static const SimdBackend backend = probeSimdBackend();
+    return backend;
+}
+
+const char* simdBackendName(SimdBackend backend) {
+    switch (backend) {
+        case SimdBackend::SCALAR: return "scalar";
+        case SimdBackend::NEON: return "neon";
+        case SimdBackend::AVX2: return "avx2";
+        case SimdBackend::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+void calculateCollisionTimes(double x0, double y0, double vx0, double vy0,
+                             const double* xs, const double* ys,
+                             const double* vxs, const double* vys,
+                             size_t count, double radius, double* out) {
+    calculateCollisionTimes(detectSimdBackend(), x0, y0, vx0, vy0,
+                            xs, ys, vxs, vys, count, radius, out);
+}
+
+void calculateCollisionTimes(SimdBackend backend,
+                             double x0, double y0, double vx0, double vy0,
+                             const double* xs, const double* ys,
+                             const double* vxs, const double* vys,
+                             size_t count, double radius, double* out) {
+    if (!isBackendSupported(backend)) {
+        backend = SimdBackend::SCALAR;
+    }
+
+    size_t done = 0;
+    switch (backend) {
+#if defined(BOAT_PRO_KERNEL_X86)
+        case SimdBackend::AVX512:
+            done = collisionTimesAvx512(x0, y0, vx0, vy0, xs, ys, vxs, vys, count, radius, out);
+            break;
+        case SimdBackend::AVX2:
+            done = collisionTimesAvx2(x0, y0, vx0, vy0, xs, ys, vxs, vys, count, radius, out);
+            break;
+#endif
+#if defined(BOAT_PRO_KERNEL_NEON)
+        case SimdBackend::NEON:
+            done = collisionTimesNeon(x0, y0, vx0, vy0, xs, ys, vxs, vys, count, radius, out);
+            break;
+#endif
+        default:
+            break;
+    }
+
+    // 剩余不足一组的尾部用标量处理
+    collisionTimesScalar(x0, y0, vx0, vy0, xs, ys, vxs, vys, done, count, radius, out);
+}
+
+} // namespace geometry
+} // namespace boat_pro
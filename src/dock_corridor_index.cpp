@@ -0,0 +1,112 @@
+// ==================== src/dock_corridor_index.cpp ====================
+#include "dock_corridor_index.h"
+#include <algorithm>
+#include <cmath>
+
+namespace boat_pro {
+
+void DockCorridorIndex::setDocks(const std::vector<DockInfo>& docks) {
+    dock_info_ = docks;
+    docks_.clear();
+    cells_.clear();
+    projected_ = false;
+}
+
+void DockCorridorIndex::projectDocks(const BoatSnapshot& snapshot, double radius) {
+    // 投影原点与通道半径不变时船坞坐标与网格保持有效
+    if (projected_ && radius_ == radius &&
+        origin_.lat == snapshot.origin.lat && origin_.lng == snapshot.origin.lng) {
+        return;
+    }
+    origin_ = snapshot.origin;
+    radius_ = radius;
+    projected_ = true;
+
+    docks_.clear();
+    cells_.clear();
+    if (radius <= 0) return;
+
+    // 单元边长为通道直径，每个通道的外接方框最多覆盖2x2个单元
+    cell_size_ = 2.0 * radius;
+    for (const auto& dock : dock_info_) {
+        Dock projected;
+        projected.dock_id = dock.dock_id;
+        snapshot.project(dock.lat, dock.lng, projected.x, projected.y);
+
+        int index = static_cast<int>(docks_.size());
+        docks_.push_back(projected);
+        for (int32_t cx = cellCoord(projected.x - radius); cx <= cellCoord(projected.x + radius); ++cx) {
+            for (int32_t cy = cellCoord(projected.y - radius); cy <= cellCoord(projected.y + radius); ++cy) {
+                cells_[cellKey(cx, cy)].push_back(index);
+            }
+        }
+    }
+}
+
+void DockCorridorIndex::build(const BoatSnapshot& snapshot, double radius) {
+    projectDocks(snapshot, radius);
+
+    size_t boat_count = snapshot.size();
+    boat_docks_.assign(boat_count, kNoDock);
+    if (docks_.empty()) return;
+
+    for (size_t i = 0; i < boat_count; ++i) {
+        boat_docks_[i] = locate(snapshot.x[i], snapshot.y[i]);
+    }
+}
+
+int DockCorridorIndex::locate(double x, double y) const {
+    if (docks_.empty()) return kNoDock;
+
+    auto it = cells_.find(cellKey(cellCoord(x), cellCoord(y)));
+    if (it == cells_.end()) return kNoDock;
+
+    // 通道重叠时取最近的船坞，距离相同时取序号较小者
+    int best = kNoDock;
+    double best_distance_sq = radius_ * radius_;
+    for (int dock : it->second) {
+        double dx = x - docks_[dock].x;
+        double dy = y - docks_[dock].y;
+        double distance_sq = dx * dx + dy * dy;
+        if (distance_sq < best_distance_sq || (distance_sq == best_distance_sq && best == kNoDock)) {
+            best = dock;
+            best_distance_sq = distance_sq;
+        }
+    }
+    return best;
+}
+
+int DockCorridorIndex::getDock(size_t boat) const {
+    return boat < boat_docks_.size() ? boat_docks_[boat] : kNoDock;
+}
+
+void DockCorridorIndex::setBoatDock(size_t boat, int dock) {
+    if (boat >= boat_docks_.size()) boat_docks_.resize(boat + 1, kNoDock);
+    boat_docks_[boat] = dock;
+}
+
+bool DockCorridorIndex::reaches(int dock, double x, double y, double vx, double vy,
+                                double horizon) const {
+    // 航迹线段 [p, p + v * horizon] 到船坞圆心的最近距离不超过通道半径
+    double dx = docks_[dock].x - x;
+    double dy = docks_[dock].y - y;
+    double speed_sq = vx * vx + vy * vy;
+    double t = 0.0;
+    if (speed_sq > 0) {
+        t = std::max(0.0, std::min(horizon, (dx * vx + dy * vy) / speed_sq));
+    }
+    double ex = dx - vx * t;
+    double ey = dy - vy * t;
+    return ex * ex + ey * ey <= radius_ * radius_;
+}
+
+int32_t DockCorridorIndex::cellCoord(double v) const {
+    return static_cast<int32_t>(std::floor(v / cell_size_));
+}
+
+uint64_t DockCorridorIndex::cellKey(int32_t cx, int32_t cy) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+           static_cast<uint64_t>(static_cast<uint32_t>(cy));
+}
+
+} // namespace boat_pro
@@ -1,6 +1,8 @@
 // ==================== src/fleet_manager.cpp ====================
 #include "fleet_manager.h"
 #include "geometry_utils.h"
+#include <algorithm>
+#include <cmath>
 #include <thread>
 #include <chrono>
 #include <iostream>
@@ -8,22 +10,66 @@
 namespace boat_pro {
 
 FleetManager::FleetManager(const SystemConfig& config) 
-    : config_(config), monitoring_active_(false) {
+    : config_(config), monitoring_active_(false), detected_version_(0),
+      live_alerts_(std::make_shared<const std::vector<CollisionAlert>>()),
+      partitioner_(static_cast<size_t>(std::max(1, config.detection_shards))),
+      sharded_version_(0), has_shard_origin_(false), next_alert_id_(1) {
     collision_detector_ = std::make_unique<CollisionDetector>(config);
+    
+    if (config.detection_shards > 1) {
+        // 分片之间并行，分片内部单线程检测
+        SystemConfig shard_config = config;
+        shard_config.detection_threads = 1;
+        size_t shard_count = partitioner_.getShardCount();
+        for (size_t s = 0; s < shard_count; ++s) {
+            shard_detectors_.push_back(std::make_unique<CollisionDetector>(shard_config));
+        }
+        size_t workers = config.detection_threads > 0
+                             ? static_cast<size_t>(config.detection_threads)
+                             : std::max(1u, std::thread::hardware_concurrency());
+        shard_pool_ = std::make_unique<WorkStealingThreadPool>(std::min(workers, shard_count));
+        shard_tables_.resize(shard_count);
+        shard_deltas_.resize(shard_count);
+        shard_owned_.resize(shard_count);
+        shard_snapshots_.resize(shard_count);
+        shard_route_indexes_.resize(shard_count);
+        shard_leaders_.resize(shard_count);
+    }
+}
+
+FleetManager::~FleetManager() {
+    stopSafetyMonitoring();
 }
 
 void FleetManager::setAlertCallback(AlertCallback callback) {
     alert_callback_ = callback;
 }
 
+void FleetManager::setAlertDeltaCallback(AlertDeltaCallback callback) {
+    alert_delta_callback_ = callback;
+}
+
 void FleetManager::initializeDocks(const std::vector<DockInfo>& docks) {
     dock_info_ = docks;
+    harbor_index_.build(dock_info_);
+    std::lock_guard<std::mutex> lock(detection_mutex_);
     collision_detector_->setDockInfo(docks);
+    for (auto& detector : shard_detectors_) {
+        detector->setDockInfo(docks);
+    }
 }
 
 void FleetManager::initializeRoutes(const std::vector<RouteInfo>& routes) {
     route_info_ = routes;
+    std::lock_guard<std::mutex> lock(detection_mutex_);
     collision_detector_->setRouteInfo(routes);
+    for (auto& index : shard_route_indexes_) {
+        index.setRoutes(routes);
+    }
+    sharded_version_ = 0;
+    for (auto& detector : shard_detectors_) {
+        detector->setRouteInfo(routes);
+    }
 }
 
 // 【新增】初始化通信系统
@@ -80,12 +126,11 @@ void FleetManager::stopCommunication() {
 }
 
 void FleetManager::updateBoatState(const BoatState& boat) {
-    std::vector<BoatState> boats = {boat};
-    collision_detector_->updateBoatStates(boats);
+    state_store_.update(boat);
 }
 
 void FleetManager::updateBoatStates(const std::vector<BoatState>& boats) {
-    collision_detector_->updateBoatStates(boats);
+    state_store_.replace(boats);
 }
 
 // 【新增】通过网络广播船只状态
@@ -135,46 +180,247 @@ bool FleetManager::requestDocking(int boat_id) {
 }
 
 int FleetManager::getRecommendedDock(int boat_id) {
-    // 这里应该获取当前船只状态，但为了简化，返回第一个可用船坞
-    return dock_info_.empty() ? -1 : dock_info_[0].dock_id;
+    // 按船只最新位置推荐最近的船坞；尚无该船状态时返回第一个船坞
+    if (dock_info_.empty()) return -1;
+    state_store_.flush();
+    BoatStateStore::SnapshotPtr fleet = state_store_.load();
+    const PackedBoatState* boat = fleet->find(boat_id);
+    if (!boat) return dock_info_[0].dock_id;
+    return findNearestAvailableDock(boat->unpack());
 }
 
 void FleetManager::runSafetyMonitoring() {
-    monitoring_active_ = true;
+    if (monitoring_active_.exchange(true)) return;
     
-    std::thread monitoring_thread([this]() {
+    monitoring_thread_ = std::thread([this]() {
         while (monitoring_active_) {
-            // 检测碰撞风险
-            auto alerts = collision_detector_->detectCollisions();
-            
-            // 处理告警
-            for (const auto& alert : alerts) {
-                if (alert_callback_) {
-                    alert_callback_(alert);
-                } else {
-                    // 默认输出告警信息
-                    std::cout << "碰撞告警 - 船只ID: " << alert.current_boat_id 
-                              << ", 等级: " << static_cast<int>(alert.level)
-                              << ", 建议: " << alert.decision_advice << std::endl;
-                }
-            }
+            // 检测碰撞风险，只处理告警变化
+            runDetectionPass();
             
             // 休眠100毫秒后继续检测
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     });
+}
+
+void FleetManager::runDetectionPass() {
+    std::vector<AlertDelta> deltas;
+    {
+        std::lock_guard<std::mutex> lock(detection_mutex_);
+        deltas = detectLatest();
+        std::atomic_store_explicit(
+            &live_alerts_,
+            std::make_shared<const std::vector<CollisionAlert>>(latestAlerts()),
+            std::memory_order_release);
+    }
     
-    monitoring_thread.detach();
+    // 处理告警变化
+    for (const auto& delta : deltas) {
+        if (alert_delta_callback_) {
+            alert_delta_callback_(delta);
+        }
+        if (alert_callback_) {
+            alert_callback_(delta.alert);
+        } else if (!alert_delta_callback_) {
+            // 默认输出告警信息
+            std::cout << "碰撞告警 - 船只ID: " << delta.alert.current_boat_id
+                      << ", 告警ID: " << delta.alert.alert_id
+                      << ", 事件: " << static_cast<int>(delta.event)
+                      << ", 等级: " << static_cast<int>(delta.alert.level)
+                      << ", 建议: " << delta.alert.decision_advice << std::endl;
+        }
+    }
 }
 
 void FleetManager::stopSafetyMonitoring() {
     monitoring_active_ = false;
+    if (monitoring_thread_.joinable()) {
+        monitoring_thread_.join();
+    }
+}
+
+std::vector<CollisionAlert> FleetManager::getCurrentAlerts() const {
+    return *std::atomic_load_explicit(&live_alerts_, std::memory_order_acquire);
 }
 
-std::vector<CollisionAlert> FleetManager::getCurrentAlerts() {
+std::vector<CollisionAlert> FleetManager::detectNow() {
+    // 使用主检测器的非跟踪检测，不改变告警表，分片模式下结果同样与单一检测器一致
+    std::lock_guard<std::mutex> lock(detection_mutex_);
+    syncDetector();
     return collision_detector_->detectCollisions();
 }
 
+std::vector<AlertDelta> FleetManager::detectLatest() {
+    if (!shard_detectors_.empty()) {
+        return detectSharded();
+    }
+    syncDetector();
+    return collision_detector_->detectAlertChanges();
+}
+
+const std::vector<CollisionAlert>& FleetManager::latestAlerts() const {
+    return shard_detectors_.empty() ? collision_detector_->getCurrentAlerts() : merged_alerts_;
+}
+
+std::vector<AlertDelta> FleetManager::detectSharded() {
+    state_store_.flush();
+    BoatStateStore::SnapshotPtr fleet = state_store_.load();
+    if (fleet->version != sharded_version_) {
+        // 光环宽度取当前最大船速下告警时域内的最大作用距离，另加航线匹配的横向余量，
+        // 本片船只可能告警的对方船只都在分片内
+        double max_speed = 0.0;
+        for (const auto& boat : fleet->boats) {
+            max_speed = std::max(max_speed, std::abs(boat.getSpeed()));
+        }
+        double halo = CollisionDetector::getInteractionRange(config_, max_speed) * kShardHaloMargin +
+                      2.0 * config_.min_route_gap_m + kShardHaloSlack;
+        partitioner_.partition(fleet->boats, halo);
+        
+        // 各分片共用同一投影原点，结果与单一检测器一致
+        if (!has_shard_origin_ && !fleet->boats.empty()) {
+            shard_origin_ = fleet->boats.front().getPosition();
+            for (auto& detector : shard_detectors_) {
+                detector->setProjectionOrigin(shard_origin_);
+            }
+            has_shard_origin_ = true;
+        }
+        
+        // 航线前船的定位与分片检测器的状态更新都在分片线程池上并行执行，
+        // 串行部分只有按航线合并定位结果
+        bool route_leaders = !route_info_.empty() && !fleet->boats.empty();
+        if (route_leaders) {
+            shard_pool_->parallelFor(shard_detectors_.size(), [this](size_t shard, size_t) {
+                locateShardBoats(shard);
+            });
+            linkRouteLeaders();
+        }
+        shard_pool_->parallelFor(shard_detectors_.size(), [&](size_t shard, size_t) {
+            if (route_leaders) addRouteLeaders(shard, *fleet);
+            shard_detectors_[shard]->updateBoatStates(partitioner_.getShardBoats(shard));
+        });
+        sharded_version_ = fleet->version;
+    }
+    
+    // 全局告警表按船只当前归属分发给各分片，作为滞回与变化判断的依据；
+    // 已离开船队的船只交给0号分片解除告警
+    auto ownerOf = [this](int boat_id) {
+        int owner = partitioner_.getOwner(boat_id);
+        return owner == RegionPartitioner::kNoShard ? size_t(0) : static_cast<size_t>(owner);
+    };
+    for (auto& table : shard_tables_) {
+        table.clear();
+    }
+    for (const auto& alert : merged_alerts_) {
+        shard_tables_[ownerOf(alert.current_boat_id)].push_back(alert);
+    }
+    
+    shard_pool_->parallelFor(shard_detectors_.size(), [this](size_t shard, size_t) {
+        shard_detectors_[shard]->loadAlertTable(shard_tables_[shard]);
+        shard_deltas_[shard] = shard_detectors_[shard]->detectAlertChanges();
+    });
+    
+    // 只采用本片船只的告警与变化，跨界船对的告警不会重复
+    std::vector<AlertDelta> deltas;
+    std::vector<AlertDelta> cleared;
+    merged_alerts_.clear();
+    for (size_t s = 0; s < shard_detectors_.size(); ++s) {
+        for (const auto& alert : shard_detectors_[s]->getCurrentAlerts()) {
+            if (ownerOf(alert.current_boat_id) == s) merged_alerts_.push_back(alert);
+        }
+        for (auto& delta : shard_deltas_[s]) {
+            if (ownerOf(delta.alert.current_boat_id) != s) continue;
+            (delta.event == AlertEvent::CLEARED ? cleared : deltas).push_back(std::move(delta));
+        }
+    }
+    
+    // 按单一检测器的输出顺序排列：告警类型(出坞、入坞、跟随、对向)，再按船只ID
+    auto before = [](const CollisionAlert& a, const CollisionAlert& b) {
+        if (a.type != b.type) return a.type < b.type;
+        return a.current_boat_id < b.current_boat_id;
+    };
+    auto delta_before = [&before](const AlertDelta& a, const AlertDelta& b) {
+        return before(a.alert, b.alert);
+    };
+    std::sort(merged_alerts_.begin(), merged_alerts_.end(), before);
+    std::sort(deltas.begin(), deltas.end(), delta_before);
+    std::sort(cleared.begin(), cleared.end(), delta_before);
+    
+    // 新告警按合并后的顺序分配全局ID，其余告警沿用全局告警表中的ID
+    size_t position = 0;
+    for (auto& delta : deltas) {
+        while (before(merged_alerts_[position], delta.alert)) ++position;
+        if (delta.event == AlertEvent::NEW) {
+            delta.alert.alert_id = next_alert_id_++;
+            merged_alerts_[position].alert_id = delta.alert.alert_id;
+        }
+    }
+    
+    deltas.insert(deltas.end(), std::make_move_iterator(cleared.begin()),
+                  std::make_move_iterator(cleared.end()));
+    return deltas;
+}
+
+void FleetManager::locateShardBoats(size_t shard) {
+    std::vector<PackedBoatState>& owned = shard_owned_[shard];
+    owned.clear();
+    for (const auto& boat : partitioner_.getShardBoats(shard)) {
+        if (partitioner_.getOwner(boat.sysid) == static_cast<int>(shard)) owned.push_back(boat);
+    }
+    
+    // 投影与航线匹配逐船独立，与在全船队快照上建立索引的结果相同
+    shard_snapshots_[shard].build(owned, shard_origin_);
+    shard_route_indexes_[shard].build(shard_snapshots_[shard], config_.min_route_gap_m);
+    shard_leaders_[shard].assign(owned.size(), RouteIndex::kNoBoat);
+}
+
+void FleetManager::linkRouteLeaders() {
+    route_slots_.resize(route_info_.size());
+    for (auto& slots : route_slots_) {
+        slots.clear();
+    }
+    for (size_t s = 0; s < shard_owned_.size(); ++s) {
+        const RouteIndex& index = shard_route_indexes_[s];
+        for (size_t k = 0; k < shard_owned_[s].size(); ++k) {
+            int route = index.getRoute(k);
+            if (route < 0) continue;
+            route_slots_[static_cast<size_t>(route)].push_back(
+                {index.getArcLength(k), shard_owned_[s][k].sysid,
+                 static_cast<uint32_t>(s), static_cast<uint32_t>(k)});
+        }
+    }
+    
+    // 与RouteIndex相同按(弧长, 下标)排序：快照按ID升序，下标次序即ID次序
+    shard_pool_->parallelFor(route_slots_.size(), [this](size_t route, size_t) {
+        std::vector<RouteSlot>& slots = route_slots_[route];
+        std::sort(slots.begin(), slots.end(), [](const RouteSlot& a, const RouteSlot& b) {
+            return a.arc < b.arc || (a.arc == b.arc && a.sysid < b.sysid);
+        });
+        for (size_t rank = 0; rank + 1 < slots.size(); ++rank) {
+            shard_leaders_[slots[rank].shard][slots[rank].item] = slots[rank + 1].sysid;
+        }
+    });
+}
+
+void FleetManager::addRouteLeaders(size_t shard, const FleetSnapshot& fleet) {
+    // 分片内任一船只都不会排在本片船只与其前船之间，分片内的前船因此与全局一致
+    for (int leader : shard_leaders_[shard]) {
+        if (leader == RouteIndex::kNoBoat) continue;
+        partitioner_.addBoat(shard, *fleet.find(leader));
+    }
+}
+
+BoatStateStore::SnapshotPtr FleetManager::syncDetector() {
+    // 本周期暂存的单条更新一次合并发布；持有快照指针期间写入方可继续发布新版本，
+    // 本次检测使用完整一致的旧版本
+    state_store_.flush();
+    BoatStateStore::SnapshotPtr fleet = state_store_.load();
+    if (fleet->version != detected_version_) {
+        collision_detector_->updateBoatStates(fleet->boats);
+        detected_version_ = fleet->version;
+    }
+    return fleet;
+}
+
 // 【新增】获取通信统计信息
 communication::UDPCommunicator::Statistics FleetManager::getCommunicationStatistics() const {
     if (!communicator_) {
@@ -184,11 +430,21 @@ communication::UDPCommunicator::Statistics FleetManager::getCommunicationStatist
 }
 
 bool FleetManager::canUndock(int boat_id, int dock_id) {
-    // 简化实现：检查是否有高优先级船只在附近
-    auto alerts = collision_detector_->detectCollisions();
+    // 假设船只以当前位置和航速立即开始出坞，只检查该船与邻近船只的碰撞风险
+    std::vector<CollisionAlert> alerts;
+    {
+        std::lock_guard<std::mutex> lock(detection_mutex_);
+        BoatStateStore::SnapshotPtr fleet = syncDetector();
+        const PackedBoatState* boat = fleet->find(boat_id);
+        if (!boat) return true;
+        
+        BoatState undocking = boat->unpack();
+        undocking.status = BoatStatus::UNDOCKING;
+        alerts = collision_detector_->evaluateBoat(boat_id, undocking);
+    }
     
     for (const auto& alert : alerts) {
-        if (alert.current_boat_id == boat_id && alert.level != AlertLevel::NORMAL) {
+        if (alert.level != AlertLevel::NORMAL) {
             return false;
         }
     }
@@ -204,20 +460,26 @@ bool FleetManager::canDock(int boat_id, int dock_id) {
 int FleetManager::findNearestAvailableDock(const BoatState& boat) {
     if (dock_info_.empty()) return -1;
     
-    int nearest_dock = dock_info_[0].dock_id;
-    double min_distance = std::numeric_limits<double>::max();
+    // R树按投影距离找到最近船坞，投影误差范围内的候选再按大圆距离比较
+    std::vector<HarborRTree::Hit> candidates;
+    harbor_index_.nearest(boat.getPosition(), 1, candidates);
+    double reach = candidates.front().distance * (1.0 + kDockProjectionTolerance) + kDockProjectionSlack;
+    harbor_index_.withinRadius(boat.getPosition(), reach, candidates);
     
-    for (const auto& dock : dock_info_) {
-        double distance = geometry::calculateDistance(
-            boat.getPosition(), dock.getPosition());
-        
-        if (distance < min_distance) {
-            min_distance = distance;
-            nearest_dock = dock.dock_id;
-        }
+    // 候选按船坞序号排列，距离相同时取序号较小的船坞
+    std::sort(candidates.begin(), candidates.end(),
+              [](const HarborRTree::Hit& a, const HarborRTree::Hit& b) { return a.item < b.item; });
+    std::vector<double> lats, lngs, distances(candidates.size());
+    for (const auto& candidate : candidates) {
+        lats.push_back(dock_info_[candidate.item].lat);
+        lngs.push_back(dock_info_[candidate.item].lng);
     }
+    geometry::TrigMode mode = config_.fast_trig ? geometry::TrigMode::FAST : geometry::TrigMode::EXACT;
+    geometry::calculateDistances(mode, boat.getPosition(), lats.data(), lngs.data(),
+                                 candidates.size(), distances.data());
     
-    return nearest_dock;
+    size_t nearest = std::min_element(distances.begin(), distances.end()) - distances.begin();
+    return dock_info_[candidates[nearest].item].dock_id;
 }
 
 // 【新增】处理接收到的Drone ID消息
@@ -1,8 +1,15 @@
 // ==================== src/geometry_utils.cpp ====================
 #include "geometry_utils.h"
+#include "collision_kernel.h"
+#include "fast_trig.h"
 #include <cmath>
 #include <algorithm>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define BOAT_PRO_GEOMETRY_X86 1
+#include <immintrin.h>
+#endif
+
 namespace boat_pro {
 namespace geometry {
 
@@ -52,6 +59,349 @@ GeoPoint calculateDestination(const GeoPoint& start, double bearing, double dist
     return GeoPoint(toDegrees(lat2_rad), toDegrees(lng2_rad));
 }
 
+namespace {
+
+// 三角函数实现，批量计算按模板参数选择，循环内不经函数指针调用
+struct ExactTrig {
+    static double sin(double x) { return std::sin(x); }
+    static double cos(double x) { return std::cos(x); }
+    static double atan2(double y, double x) { return std::atan2(y, x); }
+    static double asin(double x) { return std::asin(x); }
+};
+
+struct FastTrig {
+    static double sin(double x) { return fast::sin(x); }
+    static double cos(double x) { return fast::cos(x); }
+    static double atan2(double y, double x) { return fast::atan2(y, x); }
+    static double asin(double x) { return fast::asin(x); }
+};
+
+// 批量版本按与标量版本相同的运算顺序求值，只把原点的三角函数提出循环；
+// 标准库模式逐点调用libm，不做向量化。快速模式另有AVX2实现，每次处理4个点
+template<typename Trig>
+void distancesImpl(const GeoPoint& origin, const double* lats, const double* lngs,
+                   size_t count, double* out) {
+    const double lat1_rad = toRadians(origin.lat);
+    const double cos_lat1 = Trig::cos(lat1_rad);
+
+    for (size_t k = 0; k < count; ++k) {
+        double lat2_rad = toRadians(lats[k]);
+        double sin_dlat = Trig::sin(toRadians(lats[k] - origin.lat) / 2);
+        double sin_dlng = Trig::sin(toRadians(lngs[k] - origin.lng) / 2);
+
+        double a = sin_dlat * sin_dlat +
+                   cos_lat1 * Trig::cos(lat2_rad) * sin_dlng * sin_dlng;
+        out[k] = EARTH_RADIUS * (2 * Trig::atan2(std::sqrt(a), std::sqrt(1 - a)));
+    }
+}
+
+template<typename Trig>
+void bearingsImpl(const GeoPoint& origin, const double* lats, const double* lngs,
+                  size_t count, double* out) {
+    const double lat1_rad = toRadians(origin.lat);
+    const double sin_lat1 = Trig::sin(lat1_rad);
+    const double cos_lat1 = Trig::cos(lat1_rad);
+
+    for (size_t k = 0; k < count; ++k) {
+        double lat2_rad = toRadians(lats[k]);
+        double delta_lng = toRadians(lngs[k] - origin.lng);
+        double cos_lat2 = Trig::cos(lat2_rad);
+
+        double y = Trig::sin(delta_lng) * cos_lat2;
+        double x = cos_lat1 * Trig::sin(lat2_rad) - sin_lat1 * cos_lat2 * Trig::cos(delta_lng);
+
+        // atan2的结果在[-180, 180]内，一次修正即可落入[0, 360)
+        double bearing = toDegrees(Trig::atan2(y, x));
+        bearing = bearing < 0 ? bearing + 360.0 : bearing;
+        out[k] = bearing >= 360.0 ? bearing - 360.0 : bearing;
+    }
+}
+
+template<typename Trig>
+void destinationsImpl(const double* lats, const double* lngs,
+                      const double* bearings, const double* distances,
+                      size_t count, double* out_lats, double* out_lngs) {
+    for (size_t k = 0; k < count; ++k) {
+        double lat1_rad = toRadians(lats[k]);
+        double lng1_rad = toRadians(lngs[k]);
+        double bearing_rad = toRadians(bearings[k]);
+        double angular_distance = distances[k] / EARTH_RADIUS;
+
+        double sin_lat1 = Trig::sin(lat1_rad);
+        double cos_lat1 = Trig::cos(lat1_rad);
+        double sin_ad = Trig::sin(angular_distance);
+        double cos_ad = Trig::cos(angular_distance);
+
+        double lat2_rad = Trig::asin(sin_lat1 * cos_ad + cos_lat1 * sin_ad * Trig::cos(bearing_rad));
+        double lng2_rad = lng1_rad + Trig::atan2(Trig::sin(bearing_rad) * sin_ad * cos_lat1,
+                                                 cos_ad - sin_lat1 * Trig::sin(lat2_rad));
+
+        // 先读完第k个输入再写出，允许输出与输入为同一数组
+        out_lats[k] = toDegrees(lat2_rad);
+        out_lngs[k] = toDegrees(lng2_rad);
+    }
+}
+
+#if defined(BOAT_PRO_GEOMETRY_X86)
+
+// 与 fast::sincos/atan2/asin 相同的缩减方法与系数，4路并行；使用FMA，结果与标量快速版本
+// 在末位上可能不同，误差界不变
+struct Avx2Trig {
+    __attribute__((target("avx2,fma")))
+    static __m256d horner(const double* coeffs, size_t n, __m256d z) {
+        __m256d p = _mm256_set1_pd(coeffs[n - 1]);
+        for (size_t i = n - 1; i-- > 0;) p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(coeffs[i]));
+        return p;
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void sincos(__m256d x, __m256d& out_sin, __m256d& out_cos) {
+        using namespace fast::detail;
+        __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kTwoOverPi)),
+                                        _mm256_set1_pd(kRoundMagic));
+        __m256d k = _mm256_sub_pd(shifted, _mm256_set1_pd(kRoundMagic));
+        __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(kHalfPiHi))),
+                                  _mm256_mul_pd(k, _mm256_set1_pd(kHalfPiLo)));
+        __m256d z = _mm256_mul_pd(r, r);
+        __m256d s = _mm256_mul_pd(r, horner(kSinCoeffs, 5, z));
+        __m256d c = horner(kCosCoeffs, 5, z);
+
+        // 尾数低位为象限：第0位交换正弦与余弦，第1位决定符号
+        __m256i quadrant = _mm256_castpd_si256(shifted);
+        __m256i one = _mm256_set1_epi64x(1);
+        __m256i two = _mm256_set1_epi64x(2);
+        __m256d swap = _mm256_castsi256_pd(
+            _mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+        __m256d sin_value = _mm256_blendv_pd(s, c, swap);
+        __m256d cos_value = _mm256_blendv_pd(c, s, swap);
+        __m256i sin_sign = _mm256_slli_epi64(_mm256_and_si256(quadrant, two), 62);
+        __m256i cos_sign = _mm256_slli_epi64(
+            _mm256_and_si256(_mm256_add_epi64(quadrant, one), two), 62);
+        out_sin = _mm256_xor_pd(sin_value, _mm256_castsi256_pd(sin_sign));
+        out_cos = _mm256_xor_pd(cos_value, _mm256_castsi256_pd(cos_sign));
+    }
+
+    __attribute__((target("avx2,fma")))
+    static __m256d atan2(__m256d y, __m256d x) {
+        using namespace fast::detail;
+        const __m256d sign = _mm256_set1_pd(-0.0);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d one = _mm256_set1_pd(1.0);
+        __m256d ax = _mm256_andnot_pd(sign, x);
+        __m256d ay = _mm256_andnot_pd(sign, y);
+        __m256d steep = _mm256_cmp_pd(ay, ax, _CMP_GT_OQ);
+        __m256d hi = _mm256_blendv_pd(ax, ay, steep);
+        __m256d lo = _mm256_blendv_pd(ay, ax, steep);
+        __m256d a = _mm256_div_pd(lo, _mm256_blendv_pd(one, hi, _mm256_cmp_pd(hi, zero, _CMP_GT_OQ)));
+
+        __m256d reduce = _mm256_cmp_pd(a, _mm256_set1_pd(kTanEighthPi), _CMP_GT_OQ);
+        __m256d t = _mm256_blendv_pd(a, _mm256_div_pd(_mm256_sub_pd(a, one), _mm256_add_pd(a, one)),
+                                     reduce);
+        __m256d angle = _mm256_fmadd_pd(t, horner(kAtanCoeffs, 6, _mm256_mul_pd(t, t)),
+                                        _mm256_and_pd(reduce, _mm256_set1_pd(kQuarterPi)));
+
+        angle = _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(kHalfPi), angle), steep);
+        angle = _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(kPi), angle),
+                                 _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+        return _mm256_or_pd(angle, _mm256_and_pd(y, sign));
+    }
+
+    __attribute__((target("avx2,fma")))
+    static __m256d asin(__m256d x) {
+        __m256d one = _mm256_set1_pd(1.0);
+        __m256d c = _mm256_mul_pd(_mm256_sub_pd(one, x), _mm256_add_pd(one, x));
+        return atan2(x, _mm256_sqrt_pd(_mm256_max_pd(c, _mm256_setzero_pd())));
+    }
+};
+
+__attribute__((target("avx2,fma")))
+size_t distancesAvx2(const GeoPoint& origin, const double* lats, const double* lngs,
+                     size_t count, double* out) {
+    const __m256d deg_to_rad = _mm256_set1_pd(M_PI / 180.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d diameter = _mm256_set1_pd(2 * EARTH_RADIUS);
+    const __m256d lat0 = _mm256_set1_pd(origin.lat);
+    const __m256d lng0 = _mm256_set1_pd(origin.lng);
+    const __m256d cos_lat1 = _mm256_set1_pd(fast::cos(toRadians(origin.lat)));
+
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256d lat = _mm256_loadu_pd(lats + k);
+        __m256d lng = _mm256_loadu_pd(lngs + k);
+        __m256d sin_dlat, sin_dlng, sin_lat2, cos_lat2, unused;
+        Avx2Trig::sincos(_mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(lat, lat0), deg_to_rad), half),
+                         sin_dlat, unused);
+        Avx2Trig::sincos(_mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(lng, lng0), deg_to_rad), half),
+                         sin_dlng, unused);
+        Avx2Trig::sincos(_mm256_mul_pd(lat, deg_to_rad), sin_lat2, cos_lat2);
+
+        __m256d a = _mm256_fmadd_pd(_mm256_mul_pd(cos_lat1, cos_lat2),
+                                    _mm256_mul_pd(sin_dlng, sin_dlng),
+                                    _mm256_mul_pd(sin_dlat, sin_dlat));
+        __m256d c = Avx2Trig::atan2(_mm256_sqrt_pd(a), _mm256_sqrt_pd(_mm256_sub_pd(one, a)));
+        _mm256_storeu_pd(out + k, _mm256_mul_pd(diameter, c));
+    }
+    return k;
+}
+
+__attribute__((target("avx2,fma")))
+size_t bearingsAvx2(const GeoPoint& origin, const double* lats, const double* lngs,
+                    size_t count, double* out) {
+    const __m256d deg_to_rad = _mm256_set1_pd(M_PI / 180.0);
+    const __m256d rad_to_deg = _mm256_set1_pd(180.0 / M_PI);
+    const __m256d full_turn = _mm256_set1_pd(360.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d lng0 = _mm256_set1_pd(origin.lng);
+    double sin_lat1_value, cos_lat1_value;
+    fast::sincos(toRadians(origin.lat), sin_lat1_value, cos_lat1_value);
+    const __m256d sin_lat1 = _mm256_set1_pd(sin_lat1_value);
+    const __m256d cos_lat1 = _mm256_set1_pd(cos_lat1_value);
+
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256d sin_lat2, cos_lat2, sin_dlng, cos_dlng;
+        Avx2Trig::sincos(_mm256_mul_pd(_mm256_loadu_pd(lats + k), deg_to_rad), sin_lat2, cos_lat2);
+        Avx2Trig::sincos(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(lngs + k), lng0), deg_to_rad),
+                         sin_dlng, cos_dlng);
+
+        __m256d y = _mm256_mul_pd(sin_dlng, cos_lat2);
+        __m256d x = _mm256_fmsub_pd(cos_lat1, sin_lat2,
+                                    _mm256_mul_pd(_mm256_mul_pd(sin_lat1, cos_lat2), cos_dlng));
+
+        __m256d bearing = _mm256_mul_pd(Avx2Trig::atan2(y, x), rad_to_deg);
+        bearing = _mm256_blendv_pd(bearing, _mm256_add_pd(bearing, full_turn),
+                                   _mm256_cmp_pd(bearing, zero, _CMP_LT_OQ));
+        bearing = _mm256_blendv_pd(bearing, _mm256_sub_pd(bearing, full_turn),
+                                   _mm256_cmp_pd(bearing, full_turn, _CMP_GE_OQ));
+        _mm256_storeu_pd(out + k, bearing);
+    }
+    return k;
+}
+
+__attribute__((target("avx2,fma")))
+size_t destinationsAvx2(const double* lats, const double* lngs,
+                        const double* bearings, const double* distances,
+                        size_t count, double* out_lats, double* out_lngs) {
+    const __m256d deg_to_rad = _mm256_set1_pd(M_PI / 180.0);
+    const __m256d rad_to_deg = _mm256_set1_pd(180.0 / M_PI);
+    const __m256d inv_radius = _mm256_set1_pd(1.0 / EARTH_RADIUS);
+
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256d lat1 = _mm256_mul_pd(_mm256_loadu_pd(lats + k), deg_to_rad);
+        __m256d lng1 = _mm256_mul_pd(_mm256_loadu_pd(lngs + k), deg_to_rad);
+        __m256d sin_lat1, cos_lat1, sin_b, cos_b, sin_ad, cos_ad;
+        Avx2Trig::sincos(lat1, sin_lat1, cos_lat1);
+        Avx2Trig::sincos(_mm256_mul_pd(_mm256_loadu_pd(bearings + k), deg_to_rad), sin_b, cos_b);
+        Avx2Trig::sincos(_mm256_mul_pd(_mm256_loadu_pd(distances + k), inv_radius), sin_ad, cos_ad);
+
+        __m256d sin_lat2 = _mm256_fmadd_pd(sin_lat1, cos_ad,
+                                           _mm256_mul_pd(_mm256_mul_pd(cos_lat1, sin_ad), cos_b));
+        __m256d lat2 = Avx2Trig::asin(sin_lat2);
+        __m256d lng2 = _mm256_add_pd(lng1, Avx2Trig::atan2(
+            _mm256_mul_pd(_mm256_mul_pd(sin_b, sin_ad), cos_lat1),
+            _mm256_fnmadd_pd(sin_lat1, sin_lat2, cos_ad)));
+
+        // 4个输入全部读完后再写出，允许输出与输入为同一数组
+        _mm256_storeu_pd(out_lats + k, _mm256_mul_pd(lat2, rad_to_deg));
+        _mm256_storeu_pd(out_lngs + k, _mm256_mul_pd(lng2, rad_to_deg));
+    }
+    return k;
+}
+
+bool useAvx2() {
+    static const bool supported = (detectSimdBackend() == SimdBackend::AVX2 ||
+                                   detectSimdBackend() == SimdBackend::AVX512) &&
+                                  __builtin_cpu_supports("fma");
+    return supported;
+}
+
+#endif
+
+} // namespace
+
+double calculateDistance(TrigMode mode, const GeoPoint& p1, const GeoPoint& p2) {
+    if (mode == TrigMode::EXACT) return calculateDistance(p1, p2);
+    double distance;
+    distancesImpl<FastTrig>(p1, &p2.lat, &p2.lng, 1, &distance);
+    return distance;
+}
+
+double calculateBearing(TrigMode mode, const GeoPoint& from, const GeoPoint& to) {
+    if (mode == TrigMode::EXACT) return calculateBearing(from, to);
+    double bearing;
+    bearingsImpl<FastTrig>(from, &to.lat, &to.lng, 1, &bearing);
+    return bearing;
+}
+
+GeoPoint calculateDestination(TrigMode mode, const GeoPoint& start, double bearing, double distance) {
+    if (mode == TrigMode::EXACT) return calculateDestination(start, bearing, distance);
+    GeoPoint destination;
+    destinationsImpl<FastTrig>(&start.lat, &start.lng, &bearing, &distance, 1,
+                               &destination.lat, &destination.lng);
+    return destination;
+}
+
+void calculateDistances(const GeoPoint& origin, const double* lats, const double* lngs,
+                        size_t count, double* out) {
+    distancesImpl<ExactTrig>(origin, lats, lngs, count, out);
+}
+
+void calculateDistances(TrigMode mode, const GeoPoint& origin, const double* lats, const double* lngs,
+                        size_t count, double* out) {
+    if (mode == TrigMode::FAST) {
+        size_t done = 0;
+#if defined(BOAT_PRO_GEOMETRY_X86)
+        if (useAvx2()) done = distancesAvx2(origin, lats, lngs, count, out);
+#endif
+        distancesImpl<FastTrig>(origin, lats + done, lngs + done, count - done, out + done);
+    } else {
+        distancesImpl<ExactTrig>(origin, lats, lngs, count, out);
+    }
+}
+
+void calculateBearings(const GeoPoint& origin, const double* lats, const double* lngs,
+                       size_t count, double* out) {
+    bearingsImpl<ExactTrig>(origin, lats, lngs, count, out);
+}
+
+void calculateBearings(TrigMode mode, const GeoPoint& origin, const double* lats, const double* lngs,
+                       size_t count, double* out) {
+    if (mode == TrigMode::FAST) {
+        size_t done = 0;
+#if defined(BOAT_PRO_GEOMETRY_X86)
+        if (useAvx2()) done = bearingsAvx2(origin, lats, lngs, count, out);
+#endif
+        bearingsImpl<FastTrig>(origin, lats + done, lngs + done, count - done, out + done);
+    } else {
+        bearingsImpl<ExactTrig>(origin, lats, lngs, count, out);
+    }
+}
+
+void calculateDestinations(const double* lats, const double* lngs,
+                           const double* bearings, const double* distances,
+                           size_t count, double* out_lats, double* out_lngs) {
+    destinationsImpl<ExactTrig>(lats, lngs, bearings, distances, count, out_lats, out_lngs);
+}
+
+void calculateDestinations(TrigMode mode, const double* lats, const double* lngs,
+                           const double* bearings, const double* distances,
+                           size_t count, double* out_lats, double* out_lngs) {
+    if (mode == TrigMode::FAST) {
+        size_t done = 0;
+#if defined(BOAT_PRO_GEOMETRY_X86)
+        if (useAvx2()) {
+            done = destinationsAvx2(lats, lngs, bearings, distances, count, out_lats, out_lngs);
+        }
+#endif
+        destinationsImpl<FastTrig>(lats + done, lngs + done, bearings + done, distances + done,
+                                   count - done, out_lats + done, out_lngs + done);
+    } else {
+        destinationsImpl<ExactTrig>(lats, lngs, bearings, distances, count, out_lats, out_lngs);
+    }
+}
+
 double normalizeAngle(double angle) {
     while (angle < 0) angle += 360.0;
     while (angle >= 360.0) angle -= 360.0;
@@ -79,15 +429,39 @@ double pointToLineDistance(const GeoPoint& point, const GeoPoint& lineStart, con
 double calculateCollisionTime(const GeoPoint& pos1, const GeoPoint& vel1,
                              const GeoPoint& pos2, const GeoPoint& vel2,
                              double radius) {
-    // 将地理坐标转换为局部笛卡尔坐标系进行计算
-    // 这里简化处理，假设在小范围内可以近似为平面坐标
-    
-    double dx = (pos2.lng - pos1.lng) * EARTH_RADIUS * std::cos(toRadians(pos1.lat)) / 180.0 * M_PI;
-    double dy = (pos2.lat - pos1.lat) * EARTH_RADIUS / 180.0 * M_PI;
+    // 以物体1的位置为原点投影到局部平面
+    return calculateCollisionTime(LocalProjector(pos1), pos1, vel1, pos2, vel2, radius);
+}
+
+double calculateCollisionTime(const LocalProjector& projector,
+                             const GeoPoint& pos1, const GeoPoint& vel1,
+                             const GeoPoint& pos2, const GeoPoint& vel2,
+                             double radius) {
+    double x1, y1, x2, y2;
+    projector.project(pos1.lat, pos1.lng, x1, y1);
+    projector.project(pos2.lat, pos2.lng, x2, y2);
+
+    double dvx = (vel2.lng - vel1.lng) * projector.getMetersPerDegLng();
+    double dvy = (vel2.lat - vel1.lat) * projector.getMetersPerDegLat();
+
+    return calculateCollisionTime(x2 - x1, y2 - y1, dvx, dvy, radius);
+}
+
+double calculateCollisionTime(double dx, double dy, double dvx, double dvy, double radius) {
+    double t1, t2;
+    if (!calculateCollisionInterval(dx, dy, dvx, dvy, radius, t1, t2)) {
+        return -1; // 无碰撞
+    }
     
-    double dvx = (vel2.lng - vel1.lng) * EARTH_RADIUS * std::cos(toRadians(pos1.lat)) / 180.0 * M_PI;
-    double dvy = (vel2.lat - vel1.lat) * EARTH_RADIUS / 180.0 * M_PI;
+    // 返回最小的正值时间
+    if (t1 > 0) return t1;
+    if (t2 > 0) return t2;
     
+    return -1; // 无碰撞
+}
+
+bool calculateCollisionInterval(double dx, double dy, double dvx, double dvy, double radius,
+                                double& t_enter, double& t_exit) {
     // 求解二次方程: |p1 + v1*t - p2 - v2*t|^2 = radius^2
     double a = dvx * dvx + dvy * dvy;
     double b = 2 * (dx * dvx + dy * dvy);
@@ -96,17 +470,12 @@ double calculateCollisionTime(const GeoPoint& pos1, const GeoPoint& vel1,
     double discriminant = b * b - 4 * a * c;
     
     if (discriminant < 0 || a == 0) {
-        return -1; // 无碰撞
+        return false;
     }
     
-    double t1 = (-b - std::sqrt(discriminant)) / (2 * a);
-    double t2 = (-b + std::sqrt(discriminant)) / (2 * a);
-    
-    // 返回最小的正值时间
-    if (t1 > 0) return t1;
-    if (t2 > 0) return t2;
-    
-    return -1; // 无碰撞
+    t_enter = (-b - std::sqrt(discriminant)) / (2 * a);
+    t_exit = (-b + std::sqrt(discriminant)) / (2 * a);
+    return true;
 }
 
 } // namespace geometry
@@ -0,0 +1,164 @@
+// ==================== src/harbor_rtree.cpp ====================
+#include "harbor_rtree.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+
+namespace boat_pro {
+
+void HarborRTree::build(const std::vector<DockInfo>& docks) {
+    entries_.clear();
+    nodes_.clear();
+    if (docks.empty()) return;
+
+    projector_.recenter(docks.front().getPosition());
+    for (size_t d = 0; d < docks.size(); ++d) {
+        double x, y;
+        projector_.project(docks[d].lat, docks[d].lng, x, y);
+        entries_.push_back(Entry{x, y, x, y, static_cast<uint32_t>(d)});
+    }
+
+    // 叶节点层打包船坞，其上各层打包下一层节点，直到只剩根节点
+    packLevel(entries_, 0, entries_.size(), nodes_, true);
+    size_t level_begin = 0;
+    while (nodes_.size() - level_begin > 1) {
+        size_t level_end = nodes_.size();
+        packLevel(nodes_, level_begin, level_end, nodes_, false);
+        level_begin = level_end;
+    }
+}
+
+template <typename Box>
+void HarborRTree::packLevel(std::vector<Box>& boxes, size_t begin, size_t end,
+                            std::vector<Node>& parents, bool leaf) {
+    auto centerX = [](const Box& box) { return box.min_x + box.max_x; };
+    auto centerY = [](const Box& box) { return box.min_y + box.max_y; };
+
+    // 竖条数取节点数的平方根，每条恰好容纳整数个节点
+    size_t count = end - begin;
+    size_t node_count = (count + kNodeCapacity - 1) / kNodeCapacity;
+    size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(node_count))));
+    size_t slice_size = ((node_count + slices - 1) / slices) * kNodeCapacity;
+
+    std::sort(boxes.begin() + begin, boxes.begin() + end, [&](const Box& a, const Box& b) {
+        return centerX(a) < centerX(b);
+    });
+    for (size_t s = begin; s < end; s += slice_size) {
+        std::sort(boxes.begin() + s, boxes.begin() + std::min(end, s + slice_size),
+                  [&](const Box& a, const Box& b) { return centerY(a) < centerY(b); });
+    }
+
+    // boxes与parents可能是同一数组，追加父节点后只按下标访问
+    for (size_t s = begin; s < end; s += slice_size) {
+        size_t slice_end = std::min(end, s + slice_size);
+        for (size_t group = s; group < slice_end; group += kNodeCapacity) {
+            Node node;
+            node.begin = static_cast<uint32_t>(group);
+            node.count = static_cast<uint32_t>(std::min(kNodeCapacity, slice_end - group));
+            node.leaf = leaf;
+            node.min_x = node.min_y = std::numeric_limits<double>::infinity();
+            node.max_x = node.max_y = -std::numeric_limits<double>::infinity();
+            for (size_t k = group; k < group + node.count; ++k) {
+                node.min_x = std::min(node.min_x, boxes[k].min_x);
+                node.min_y = std::min(node.min_y, boxes[k].min_y);
+                node.max_x = std::max(node.max_x, boxes[k].max_x);
+                node.max_y = std::max(node.max_y, boxes[k].max_y);
+            }
+            parents.push_back(node);
+        }
+    }
+}
+
+template <typename Box>
+double HarborRTree::boxDistanceSq(const Box& box, double px, double py) {
+    double dx = std::max({box.min_x - px, 0.0, px - box.max_x});
+    double dy = std::max({box.min_y - py, 0.0, py - box.max_y});
+    return dx * dx + dy * dy;
+}
+
+bool HarborRTree::hitLess(const Hit& a, const Hit& b) {
+    return std::tie(a.distance, a.item) < std::tie(b.distance, b.item);
+}
+
+HarborRTree::Hit HarborRTree::makeHit(const Entry& entry, double distance_sq) const {
+    return Hit{entry.item, std::sqrt(distance_sq)};
+}
+
+void HarborRTree::nearest(const GeoPoint& point, size_t k, std::vector<Hit>& out) const {
+    double px, py;
+    projector_.project(point.lat, point.lng, px, py);
+    nearest(px, py, k, out);
+}
+
+void HarborRTree::nearest(double px, double py, size_t k, std::vector<Hit>& out) const {
+    out.clear();
+    if (nodes_.empty() || k == 0) return;
+
+    // 按距离下界由近及远展开节点(最佳优先)；队首下界超过第k个结果的距离后，
+    // 剩余对象都更远。与第k个结果等距的对象全部取出，再按序号截断
+    using Item = std::tuple<double, bool, uint32_t>;  // (距离平方下界, 是否为对象, 下标)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    queue.emplace(boxDistanceSq(nodes_.back(), px, py), false, static_cast<uint32_t>(nodes_.size() - 1));
+
+    double kth_sq = std::numeric_limits<double>::infinity();
+    while (!queue.empty()) {
+        double distance_sq;
+        bool is_entry;
+        uint32_t index;
+        std::tie(distance_sq, is_entry, index) = queue.top();
+        if (distance_sq > kth_sq) break;
+        queue.pop();
+
+        if (is_entry) {
+            out.push_back(makeHit(entries_[index], distance_sq));
+            if (out.size() == k) kth_sq = distance_sq;
+            continue;
+        }
+
+        const Node& node = nodes_[index];
+        for (uint32_t c = node.begin; c < node.begin + node.count; ++c) {
+            if (node.leaf) {
+                queue.emplace(boxDistanceSq(entries_[c], px, py), true, c);
+            } else {
+                queue.emplace(boxDistanceSq(nodes_[c], px, py), false, c);
+            }
+        }
+    }
+
+    std::sort(out.begin(), out.end(), hitLess);
+    if (out.size() > k) out.resize(k);
+}
+
+void HarborRTree::withinRadius(const GeoPoint& point, double radius, std::vector<Hit>& out) const {
+    double px, py;
+    projector_.project(point.lat, point.lng, px, py);
+    withinRadius(px, py, radius, out);
+}
+
+void HarborRTree::withinRadius(double px, double py, double radius, std::vector<Hit>& out) const {
+    out.clear();
+    if (nodes_.empty() || radius < 0) return;
+
+    double radius_sq = radius * radius;
+    std::vector<uint32_t> stack = {static_cast<uint32_t>(nodes_.size() - 1)};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (boxDistanceSq(node, px, py) > radius_sq) continue;
+
+        for (uint32_t c = node.begin; c < node.begin + node.count; ++c) {
+            if (!node.leaf) {
+                stack.push_back(c);
+                continue;
+            }
+            double distance_sq = boxDistanceSq(entries_[c], px, py);
+            if (distance_sq <= radius_sq) out.push_back(makeHit(entries_[c], distance_sq));
+        }
+    }
+    std::sort(out.begin(), out.end(), hitLess);
+}
+
+} // namespace boat_pro
@@ -0,0 +1,259 @@
+// ==================== src/kinetic_tracker.cpp ====================
+#include "kinetic_tracker.h"
+#include "geometry_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace boat_pro {
+
+KineticTracker::KineticTracker(const SystemConfig& config)
+    : collision_radius_(detection::collisionRadius(config)),
+      warning_threshold_(config.warning_threshold_s),
+      max_alert_horizon_(detection::maxAlertHorizon(config)) {}
+
+void KineticTracker::markChanged(int boat_id) {
+    dirty_ids_.insert(boat_id);
+    boat_versions_[boat_id] = ++next_boat_version_;
+}
+
+void KineticTracker::forget(int boat_id) {
+    boat_versions_.erase(boat_id);
+}
+
+double KineticTracker::begin(double now, const GeoPoint& origin) {
+    // 时间回退或投影原点变化后证书不再可信，重新建立
+    if (!active_ || now - epoch_ < now_ || origin.lat != origin_.lat || origin.lng != origin_.lng) {
+        active_ = true;
+        membership_changed_ = true;
+        epoch_ = now;
+        now_ = 0.0;
+        origin_ = origin;
+        moved_.clear();
+        certificates_.clear();
+        events_ = decltype(events_)();
+        warning_pairs_.clear();
+    }
+    now_ = now - epoch_;
+    return now_;
+}
+
+void KineticTracker::update(const BoatSnapshot& snapshot, double time, double max_speed,
+                            DetectionStats& stats) {
+    size_t boat_count = snapshot.size();
+    std::vector<int> moved(dirty_ids_.begin(), dirty_ids_.end());
+    std::sort(moved.begin(), moved.end());
+    dirty_ids_.clear();
+
+    // 网格到期、有新船加入、船速超过建网格时的上界或更新船只过多时重建网格
+    bool regrid = membership_changed_ || time >= grid_expiry_ || max_speed > grid_speed_ ||
+                  (moved_.size() + moved.size()) * 4 > boat_count;
+    stats.full_revalidation = regrid;
+
+    if (regrid) {
+        rebuildGrid(snapshot, time, max_speed, stats);
+    } else {
+        moved_.insert(moved_.end(), moved.begin(), moved.end());
+        for (int boat_id : moved) {
+            size_t i = snapshot.indexOf(boat_id);
+            if (i < boat_count) recertifyMovedBoat(snapshot, i, time, stats);
+        }
+    }
+
+    processEvents(time, stats);
+}
+
+void KineticTracker::collectWarningPairs(const BoatSnapshot& snapshot, double time, double horizon,
+                                         std::vector<PairRecord>& records) {
+    size_t boat_count = snapshot.size();
+    for (auto it = warning_pairs_.begin(); it != warning_pairs_.end();) {
+        size_t i = snapshot.indexOf(it->first);
+        size_t j = snapshot.indexOf(it->second);
+        uint64_t key = detection::pairKey(it->first, it->second);
+        auto cert = certificates_.find(key);
+        if (i >= boat_count || j >= boat_count || cert == certificates_.end() ||
+            !isCertificateValid(key, cert->second)) {
+            it = warning_pairs_.erase(it);
+            continue;
+        }
+
+        double collision_time = collisionTime(cert->second, time);
+        if (collision_time > 0 && collision_time <= horizon) {
+            records.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(j), collision_time});
+        }
+        ++it;
+    }
+}
+
+void KineticTracker::rebuildGrid(const BoatSnapshot& snapshot, double now, double max_speed,
+                                 DetectionStats& stats) {
+    // 网格在[now, now + horizon]内有效：此期间进入告警时域的船对，
+    // 在now时刻的间距不超过 (|v1| + |v2|) * (T + horizon) + R
+    double horizon = warning_threshold_ * kGridHorizon;
+    double range = 2.0 * max_speed * (max_alert_horizon_ + horizon) + collision_radius_;
+    grid_.rebuild(range * detection::kGridRangeMargin + detection::kGridMinCellSize,
+                  snapshot.sysid, snapshot.x, snapshot.y);
+    grid_time_ = now;
+    grid_expiry_ = now + horizon;
+    grid_speed_ = max_speed;
+    membership_changed_ = false;
+    moved_.clear();
+
+    // 已有有效证书的邻近船对保持不变，只为新出现或失效的船对签发证书；
+    // 不再邻近的船对证书随之丢弃，证书数量受候选船对数约束
+    std::unordered_map<uint64_t, Certificate> previous;
+    previous.swap(certificates_);
+    size_t boat_count = snapshot.size();
+    for (size_t i = 0; i < boat_count; ++i) {
+        candidates_.clear();
+        grid_.queryNeighbors(snapshot.x[i], snapshot.y[i], candidates_);
+        for (int boat_id : candidates_) {
+            if (boat_id <= snapshot.sysid[i]) continue;
+            size_t j = snapshot.indexOf(boat_id);
+            if (j >= boat_count) continue;
+
+            auto it = previous.find(detection::pairKey(snapshot.sysid[i], boat_id));
+            if (it != previous.end() && isCertificateValid(it->first, it->second)) {
+                certificates_.insert(*it);
+                ++stats.candidate_pairs;
+                ++stats.cached_pairs;
+            } else {
+                certifyPair(snapshot, i, j, now, stats);
+            }
+        }
+    }
+}
+
+void KineticTracker::recertifyMovedBoat(const BoatSnapshot& snapshot, size_t i, double now,
+                                        DetectionStats& stats) {
+    // 将新轨迹反推到建网格时刻再查询，未更新船只在网格中的位置仍然准确；
+    // 建网格后更新过的船只位置已过时，逐一检查
+    double elapsed = now - grid_time_;
+    candidates_.clear();
+    grid_.queryNeighbors(snapshot.x[i] - snapshot.vx[i] * elapsed,
+                         snapshot.y[i] - snapshot.vy[i] * elapsed, candidates_);
+    candidates_.insert(candidates_.end(), moved_.begin(), moved_.end());
+
+    size_t boat_count = snapshot.size();
+    for (int boat_id : candidates_) {
+        size_t j = snapshot.indexOf(boat_id);
+        if (j >= boat_count || j == i) continue;
+        certifyPair(snapshot, std::min(i, j), std::max(i, j), now, stats);
+    }
+}
+
+void KineticTracker::certifyPair(const BoatSnapshot& snapshot, size_t i, size_t j, double now,
+                                 DetectionStats& stats) {
+    ++stats.candidate_pairs;
+
+    const BoatSnapshot& snap = snapshot;
+    std::pair<int, int> ids(snap.sysid[i], snap.sysid[j]);
+    uint64_t key = detection::pairKey(ids.first, ids.second);
+    auto it = certificates_.find(key);
+    if (it != certificates_.end() && isCertificateValid(key, it->second)) {
+        ++stats.cached_pairs;
+        return;
+    }
+    ++stats.solved_pairs;
+    warning_pairs_.erase(ids);
+
+    double t_enter = 0.0, t_exit = 0.0;
+    bool hits = geometry::calculateCollisionInterval(
+        snap.x[j] - snap.x[i], snap.y[j] - snap.y[i],
+        snap.vx[j] - snap.vx[i], snap.vy[j] - snap.vy[i],
+        collision_radius_, t_enter, t_exit);
+    Certificate cert{hits && t_exit > 0, now + t_enter, now + t_exit,
+                     getBoatVersion(ids.first), getBoatVersion(ids.second), ++next_generation_};
+    certificates_[key] = cert;
+    if (!cert.collides) return;  // 线性运动下不会再进入碰撞半径，没有事件
+
+    if (isInWarningWindow(cert, now)) {
+        warning_pairs_.insert(ids);
+    }
+    events_.push({nextWindowBoundary(cert, now), key, cert.generation});
+}
+
+void KineticTracker::processEvents(double now, DetectionStats& stats) {
+    while (!events_.empty() && events_.top().time <= now) {
+        Event event = events_.top();
+        events_.pop();
+        ++stats.kinetic_events;
+
+        // 证书已被重新签发或删除时，旧事件直接丢弃
+        auto it = certificates_.find(event.key);
+        if (it == certificates_.end() || it->second.generation != event.generation) continue;
+
+        std::pair<int, int> ids(detection::pairKeyLo(event.key), detection::pairKeyHi(event.key));
+        if (!isCertificateValid(event.key, it->second)) {
+            warning_pairs_.erase(ids);
+            certificates_.erase(it);
+            continue;
+        }
+
+        if (isInWarningWindow(it->second, event.time)) {
+            warning_pairs_.insert(ids);
+        } else {
+            warning_pairs_.erase(ids);
+        }
+
+        double next = nextWindowBoundary(it->second, event.time);
+        if (std::isinf(next)) {
+            // 两船已驶离碰撞半径，此后不会再碰撞
+            it->second.collides = false;
+        } else {
+            events_.push({next, event.key, event.generation});
+        }
+    }
+}
+
+bool KineticTracker::isCertificateValid(uint64_t key, const Certificate& cert) const {
+    return cert.version_lo == getBoatVersion(detection::pairKeyLo(key)) &&
+           cert.version_hi == getBoatVersion(detection::pairKeyHi(key));
+}
+
+uint64_t KineticTracker::getBoatVersion(int boat_id) const {
+    auto it = boat_versions_.find(boat_id);
+    return it == boat_versions_.end() ? 0 : it->second;
+}
+
+bool KineticTracker::isInWarningWindow(const Certificate& cert, double time) const {
+    if (!cert.collides) return false;
+
+    // 碰撞时间在进入碰撞半径前为 enter - time，处于半径内时为 exit - time；
+    // 时间窗两端留出余量，最终是否告警仍按碰撞时间精确判断；
+    // 时间窗按包含滞回量的告警时域计算，跟踪与非跟踪检测共用
+    double warning = max_alert_horizon_;
+    double approach_begin = cert.enter_time - warning - kWindowSlack;
+    double approach_end = cert.enter_time + kWindowSlack;
+    double contact_begin = std::max(cert.enter_time, cert.exit_time - warning) - kWindowSlack;
+    double contact_end = cert.exit_time + kWindowSlack;
+    return (time >= approach_begin && time < approach_end) ||
+           (time >= contact_begin && time < contact_end);
+}
+
+double KineticTracker::nextWindowBoundary(const Certificate& cert, double time) const {
+    double warning = max_alert_horizon_;
+    double boundaries[] = {
+        cert.enter_time - warning - kWindowSlack,
+        cert.enter_time + kWindowSlack,
+        std::max(cert.enter_time, cert.exit_time - warning) - kWindowSlack,
+        cert.exit_time + kWindowSlack,
+    };
+
+    double next = std::numeric_limits<double>::infinity();
+    for (double boundary : boundaries) {
+        if (boundary > time) next = std::min(next, boundary);
+    }
+    return next;
+}
+
+double KineticTracker::collisionTime(const Certificate& cert, double time) {
+    if (!cert.collides) return -1;
+    double t1 = cert.enter_time - time;
+    if (t1 > 0) return t1;
+    double t2 = cert.exit_time - time;
+    if (t2 > 0) return t2;
+    return -1;
+}
+
+} // namespace boat_pro
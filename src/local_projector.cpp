@@ -0,0 +1,49 @@
+// ==================== src/local_projector.cpp ====================
+#include "local_projector.h"
+#include "geometry_utils.h"
+#include <cmath>
+
+namespace boat_pro {
+namespace geometry {
+
+LocalProjector::LocalProjector() {
+    recenter(GeoPoint());
+}
+
+LocalProjector::LocalProjector(const GeoPoint& origin) {
+    recenter(origin);
+}
+
+void LocalProjector::recenter(const GeoPoint& origin) {
+    origin_ = origin;
+
+    // 切平面坐标 e = R·cosφ·sinΔλ、n = R·(sinφ·cosφ0 - cosφ·sinφ0·cosΔλ)
+    // 在原点处按Δφ、Δλ展开到二阶
+    double rad_per_deg = M_PI / 180.0;
+    double sin_lat = std::sin(toRadians(origin.lat));
+    double cos_lat = std::cos(toRadians(origin.lat));
+    ky_ = EARTH_RADIUS * rad_per_deg;
+    kx_ = ky_ * cos_lat;
+    kxy_ = ky_ * sin_lat * rad_per_deg;
+    kyy_ = 0.5 * ky_ * sin_lat * cos_lat * rad_per_deg;
+}
+
+GeoPoint LocalProjector::unproject(double px, double py) const {
+    // 由一阶近似出发做不动点迭代，两次后残差远小于1毫米
+    double dlng = px / kx_;
+    double dlat = py / ky_;
+    for (int iteration = 0; iteration < 2; ++iteration) {
+        dlat = (py - kyy_ * dlng * dlng) / ky_;
+        dlng = px / (kx_ - kxy_ * dlat);
+    }
+    return GeoPoint(origin_.lat + dlat, origin_.lng + dlng);
+}
+
+GeoPoint LocalProjector::translate(const GeoPoint& point, double east, double north) const {
+    double px, py;
+    project(point.lat, point.lng, px, py);
+    return unproject(px + east, py + north);
+}
+
+} // namespace geometry
+} // namespace boat_pro
@@ -1,6 +1,7 @@
 // ==================== apps/main.cpp ====================
 #include "fleet_manager.h"
 #include "types.h"
+#include "geometry_utils.h"
 #include <iostream>
 #include <fstream>
 #include <jsoncpp/json/json.h>  // jsoncpp header
@@ -256,17 +257,33 @@ int main() {
     // 启动安全监控
     fleet_manager.runSafetyMonitoring();
     
+    // 船只位置按批量目标点计算推进，三角函数实现由配置选择
+    const geometry::TrigMode step_mode =
+        config.fast_trig ? geometry::TrigMode::FAST : geometry::TrigMode::EXACT;
+    std::vector<double> step_lats(test_boats.size());
+    std::vector<double> step_lngs(test_boats.size());
+    std::vector<double> step_headings(test_boats.size());
+    std::vector<double> step_distances(test_boats.size());
+    
     // 模拟船只状态更新 - 逐步增加碰撞风险
     for (int i = 0; i < 12; ++i) {
         std::cout << "\n--- 第 " << (i+1) << " 秒 ---" << std::endl;
         
         // 更新船只位置
-        for (auto& boat : test_boats) {
+        for (size_t k = 0; k < test_boats.size(); ++k) {
             // 简单模拟船只移动
-            double distance = boat.speed * 1.0; // 1秒移动距离
-            boat.lat += distance * cos(boat.heading * M_PI / 180.0) / 111000.0; // 近似转换
-            boat.lng += distance * sin(boat.heading * M_PI / 180.0) / (111000.0 * cos(boat.lat * M_PI / 180.0));
-            boat.timestamp += 1.0;
+            step_lats[k] = test_boats[k].lat;
+            step_lngs[k] = test_boats[k].lng;
+            step_headings[k] = test_boats[k].heading;
+            step_distances[k] = test_boats[k].speed * 1.0; // 1秒移动距离
+        }
+        geometry::calculateDestinations(step_mode, step_lats.data(), step_lngs.data(),
+                                        step_headings.data(), step_distances.data(),
+                                        test_boats.size(), step_lats.data(), step_lngs.data());
+        for (size_t k = 0; k < test_boats.size(); ++k) {
+            test_boats[k].lat = step_lats[k];
+            test_boats[k].lng = step_lngs[k];
+            test_boats[k].timestamp += 1.0;
         }
         
         // 在特定时间点修改船只参数以产生不同级别的警告
@@ -0,0 +1,58 @@
+// ==================== src/pair_cache.cpp ====================
+#include "pair_cache.h"
+#include <algorithm>
+#include <iterator>
+
+namespace boat_pro {
+
+void PairCache::configure(bool enabled, int full_revalidation_ticks) {
+    enabled_ = enabled;
+    full_revalidation_ticks_ = std::max(1, full_revalidation_ticks);
+    force_full_ = true;
+}
+
+bool PairCache::beginPass() {
+    // 增量模式下定期全量重算，清除长期未使用的缓存项
+    full_pass_ = !enabled_ || force_full_ || ++ticks_since_full_revalidation_ >= full_revalidation_ticks_;
+    if (full_pass_) {
+        ++stamp_;
+        ticks_since_full_revalidation_ = 0;
+        force_full_ = false;
+    }
+    return full_pass_;
+}
+
+void PairCache::mapDirty(const std::vector<int>& sysids) {
+    boat_dirty_.assign(sysids.size(), 0);
+    for (size_t i = 0; i < sysids.size(); ++i) {
+        if (dirty_ids_.count(sysids[i])) boat_dirty_[i] = 1;
+    }
+    dirty_ids_.clear();
+}
+
+bool PairCache::lookup(size_t i, size_t j, uint64_t key, double& collision_time) const {
+    if (boat_dirty_[i] || boat_dirty_[j]) return false;
+    auto it = cache_.find(key);
+    if (it == cache_.end()) return false;
+    collision_time = it->second.collision_time;
+    return true;
+}
+
+void PairCache::store(uint64_t key, double collision_time) {
+    cache_[key] = {collision_time, stamp_};
+}
+
+void PairCache::endPass() {
+    // 全量重算后删除本轮未写入的缓存项；原地删除不释放其余节点，
+    // 船对集合稳定时不重新分配
+    if (full_pass_) {
+        for (auto it = cache_.begin(); it != cache_.end();) {
+            it = it->second.stamp == stamp_ ? std::next(it) : cache_.erase(it);
+        }
+    }
+
+    // 本次检测已消化所有状态变化
+    std::fill(boat_dirty_.begin(), boat_dirty_.end(), 0);
+}
+
+} // namespace boat_pro
@@ -0,0 +1,34 @@
+// ==================== src/pair_priority_queue.cpp ====================
+#include "pair_priority_queue.h"
+#include <algorithm>
+
+namespace boat_pro {
+
+void PairPriorityQueue::clear() {
+    entries_.clear();
+    heap_end_ = 0;
+}
+
+void PairPriorityQueue::append(const std::vector<Entry>& entries) {
+    entries_.insert(entries_.end(), entries.begin(), entries.end());
+}
+
+void PairPriorityQueue::heapify() {
+    heap_end_ = entries_.size();
+    std::make_heap(entries_.begin(), entries_.end(), later);
+}
+
+void PairPriorityQueue::popBatch(size_t count, std::vector<Entry>& out) {
+    out.clear();
+    while (heap_end_ > 0 && out.size() < count) {
+        std::pop_heap(entries_.begin(), entries_.begin() + heap_end_, later);
+        out.push_back(entries_[--heap_end_]);
+    }
+}
+
+bool PairPriorityQueue::later(const Entry& a, const Entry& b) {
+    if (a.lower_bound != b.lower_bound) return a.lower_bound > b.lower_bound;
+    return a.i > b.i || (a.i == b.i && a.j > b.j);
+}
+
+} // namespace boat_pro
@@ -0,0 +1,92 @@
+// ==================== src/recheck_schedule.cpp ====================
+#include "recheck_schedule.h"
+#include "detection_types.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace boat_pro {
+
+RecheckSchedule::RecheckSchedule(const SystemConfig& config)
+    : collision_radius_(detection::collisionRadius(config)),
+      max_alert_horizon_(detection::maxAlertHorizon(config)) {}
+
+void RecheckSchedule::configure(bool enabled, double max_interval_s) {
+    enabled_ = enabled;
+    max_interval_ = std::max(kMinInterval, max_interval_s);
+    schedule_.clear();
+    next_sweep_ = 0.0;
+}
+
+void RecheckSchedule::advanceClock(const std::vector<double>& timestamps) {
+    double now = timestamps.empty() ? now_ : *std::max_element(timestamps.begin(), timestamps.end());
+
+    // 时钟回退(如回放重启)时已有计划不再可信
+    if (now < now_) {
+        schedule_.clear();
+        next_sweep_ = 0.0;
+    }
+    now_ = now;
+
+    // 已到期的计划项若船对仍是候选会在本次求解时重写，其余(船对已不再是候选)在此清理
+    if (now >= next_sweep_) {
+        for (auto it = schedule_.begin(); it != schedule_.end();) {
+            it = it->second.next_check <= now ? schedule_.erase(it) : std::next(it);
+        }
+        next_sweep_ = now + max_interval_;
+    }
+}
+
+bool RecheckSchedule::isDeferred(uint64_t key, const BoatSnapshot& snap, size_t i, size_t j) const {
+    auto it = schedule_.find(key);
+    if (it == schedule_.end()) return false;
+    const Entry& entry = it->second;
+    if (now_ >= entry.next_check) return false;
+
+    // 任一船转向或变速超过容差时安排时的相对运动已不成立
+    double drift_sq = kVelocityDrift * kVelocityDrift;
+    double dxi = snap.vx[i] - entry.vx_i, dyi = snap.vy[i] - entry.vy_i;
+    double dxj = snap.vx[j] - entry.vx_j, dyj = snap.vy[j] - entry.vy_j;
+    return dxi * dxi + dyi * dyi <= drift_sq && dxj * dxj + dyj * dyj <= drift_sq;
+}
+
+bool RecheckSchedule::plan(const BoatSnapshot& snap, size_t i, size_t j, bool alert_relevant,
+                           Entry& out) const {
+    // 余量不足的船对删除计划项，每次检测都复查
+    double next = alert_relevant ? 0.0 : interval(snap, i, j);
+    out = Entry{-1.0,
+                static_cast<float>(snap.vx[i]), static_cast<float>(snap.vy[i]),
+                static_cast<float>(snap.vx[j]), static_cast<float>(snap.vy[j])};
+    if (next > 0) {
+        out.next_check = now_ + next;
+        return true;
+    }
+    return isActive();
+}
+
+void RecheckSchedule::apply(uint64_t key, const Entry& entry) {
+    if (entry.next_check < 0) {
+        schedule_.erase(key);
+    } else {
+        schedule_[key] = entry;
+    }
+}
+
+double RecheckSchedule::interval(const BoatSnapshot& snap, size_t i, size_t j) const {
+    double dx = snap.x[j] - snap.x[i];
+    double dy = snap.y[j] - snap.y[i];
+    double distance = std::hypot(dx, dy);
+    double gap = distance - collision_radius_;
+    if (gap <= 0) return 0.0;
+
+    // 匀速时间距是时间的凸函数，接近速度只会减小；两船速度各自变化不超过容差时
+    // 相对速度变化不超过kSpeedTolerance，间距减小速率不超过 接近速度+容差。
+    // 因此在 gap/(接近速度+容差) - 告警时域 之前该船对的碰撞时间不会进入告警时域
+    double closing = -(dx * (snap.vx[j] - snap.vx[i]) + dy * (snap.vy[j] - snap.vy[i])) / distance;
+    double margin = gap / (std::max(0.0, closing) + kSpeedTolerance) - max_alert_horizon_;
+    double result = kSafetyFactor * margin;
+    if (result < kMinInterval) return 0.0;
+    return std::min(result, max_interval_);
+}
+
+} // namespace boat_pro
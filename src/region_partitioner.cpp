@@ -0,0 +1,118 @@
+// ==================== src/region_partitioner.cpp ====================
+#include "region_partitioner.h"
+#include "local_projector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace boat_pro {
+
+RegionPartitioner::RegionPartitioner(size_t shard_count)
+    : shards_(std::max<size_t>(1, shard_count)) {
+}
+
+void RegionPartitioner::partition(const std::vector<PackedBoatState>& boats, double halo_m) {
+    halo_ = halo_m;
+    boundaries_.clear();
+    coords_.clear();
+    owners_.clear();
+    for (auto& shard : shards_) {
+        shard.boats.clear();
+        shard.owned_count = 0;
+    }
+    if (boats.empty()) return;
+
+    // 以第一条船为原点投影；分片边界只需大致准确，光环宽度另留余量
+    geometry::LocalProjector projector(boats.front().getPosition());
+    double min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    coords_.resize(boats.size());
+    cross_coords_.resize(boats.size());
+    for (size_t i = 0; i < boats.size(); ++i) {
+        double x, y;
+        projector.project(boats[i].getLat(), boats[i].getLng(), x, y);
+        coords_[i] = x;
+        cross_coords_[i] = y;
+        min_x = std::min(min_x, x);
+        max_x = std::max(max_x, x);
+        min_y = std::min(min_y, y);
+        max_y = std::max(max_y, y);
+    }
+
+    // 沿跨度较大的轴划分条带，条带窄边不小于光环时光环船只最少
+    if (max_x - min_x < max_y - min_y) coords_.swap(cross_coords_);
+
+    // 按船只数大致等分：分界取各分位点附近(前后各四分之一片)相邻船只间距最大处的中点，
+    // 多港区部署时分界落在港区之间的空旷水域，光环船只最少
+    size_t shard_count = shards_.size();
+    std::vector<double> sorted = coords_;
+    std::sort(sorted.begin(), sorted.end());
+    size_t window = sorted.size() / (4 * shard_count);
+    for (size_t k = 1; k < shard_count; ++k) {
+        if (sorted.size() < 2) {
+            boundaries_.push_back(sorted.front());
+            continue;
+        }
+        size_t rank = std::max<size_t>(1, k * sorted.size() / shard_count);
+        size_t first = std::max<size_t>(1, rank > window ? rank - window : 1);
+        size_t last = std::min(sorted.size() - 1, rank + window);
+        size_t best = rank;
+        for (size_t r = first; r <= last; ++r) {
+            if (sorted[r] - sorted[r - 1] > sorted[best] - sorted[best - 1]) best = r;
+        }
+        boundaries_.push_back(0.5 * (sorted[best - 1] + sorted[best]));
+    }
+    std::sort(boundaries_.begin(), boundaries_.end());
+
+    // 本片船只按ID升序先放入，光环船只在第二遍追加后整体按ID排序
+    size_t index = 0;
+    for (const auto& boat : boats) {
+        size_t owner = shardOf(coords_[index++]);
+        owners_[boat.sysid] = static_cast<int>(owner);
+        shards_[owner].boats.push_back(boat);
+        ++shards_[owner].owned_count;
+    }
+
+    index = 0;
+    for (const auto& boat : boats) {
+        double coord = coords_[index++];
+        size_t owner = static_cast<size_t>(owners_[boat.sysid]);
+        // 条带s覆盖 [boundaries_[s-1], boundaries_[s])，向两侧扩展光环宽度
+        for (size_t s = owner; s > 0 && coord < boundaries_[s - 1] + halo_m; --s) {
+            shards_[s - 1].boats.push_back(boat);
+        }
+        for (size_t s = owner + 1; s < shard_count && coord >= boundaries_[s - 1] - halo_m; ++s) {
+            shards_[s].boats.push_back(boat);
+        }
+    }
+    for (auto& shard : shards_) {
+        std::sort(shard.boats.begin(), shard.boats.end(),
+                  [](const PackedBoatState& a, const PackedBoatState& b) { return a.sysid < b.sysid; });
+    }
+}
+
+const std::vector<PackedBoatState>& RegionPartitioner::getShardBoats(size_t shard) const {
+    return shards_[shard].boats;
+}
+
+void RegionPartitioner::addBoat(size_t shard, const PackedBoatState& boat) {
+    std::vector<PackedBoatState>& boats = shards_[shard].boats;
+    auto it = std::lower_bound(boats.begin(), boats.end(), boat.sysid,
+                               [](const PackedBoatState& b, int id) { return b.sysid < id; });
+    if (it != boats.end() && it->sysid == boat.sysid) return;
+    boats.insert(it, boat);
+}
+
+size_t RegionPartitioner::getOwnedCount(size_t shard) const {
+    return shards_[shard].owned_count;
+}
+
+int RegionPartitioner::getOwner(int boat_id) const {
+    auto it = owners_.find(boat_id);
+    return it == owners_.end() ? kNoShard : it->second;
+}
+
+size_t RegionPartitioner::shardOf(double coord) const {
+    return static_cast<size_t>(std::upper_bound(boundaries_.begin(), boundaries_.end(), coord) -
+                               boundaries_.begin());
+}
+
+} // namespace boat_pro
@@ -0,0 +1,161 @@
+// ==================== src/route_geometry.cpp ====================
+#include "route_geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace boat_pro {
+
+void RouteGeometry::build(const std::vector<GeoPoint>& points, const geometry::LocalProjector& projector) {
+    start_x_.clear();
+    start_y_.clear();
+    dir_x_.clear();
+    dir_y_.clear();
+    length_.clear();
+    arc_.clear();
+    nodes_.clear();
+    if (points.size() < 2) return;
+
+    std::vector<double> xs(points.size()), ys(points.size());
+    for (size_t k = 0; k < points.size(); ++k) {
+        projector.project(points[k].lat, points[k].lng, xs[k], ys[k]);
+    }
+
+    double total = 0.0;
+    for (size_t k = 0; k + 1 < points.size(); ++k) {
+        double sx = xs[k + 1] - xs[k];
+        double sy = ys[k + 1] - ys[k];
+        double length = std::hypot(sx, sy);
+        start_x_.push_back(xs[k]);
+        start_y_.push_back(ys[k]);
+        dir_x_.push_back(length > 0 ? sx / length : 0.0);
+        dir_y_.push_back(length > 0 ? sy / length : 0.0);
+        length_.push_back(length);
+        arc_.push_back(total);
+        total += length;
+    }
+
+    // 包围盒层次的节点数不超过叶节点数的两倍
+    nodes_.reserve(2 * (segmentCount() / kLeafSegments + 1));
+    buildNode(0, static_cast<uint32_t>(segmentCount()));
+}
+
+int32_t RouteGeometry::buildNode(uint32_t begin, uint32_t end) {
+    int32_t index = static_cast<int32_t>(nodes_.size());
+    nodes_.emplace_back();
+
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.min_x = node.min_y = std::numeric_limits<double>::infinity();
+    node.max_x = node.max_y = -std::numeric_limits<double>::infinity();
+    for (uint32_t k = begin; k < end; ++k) {
+        double end_x = start_x_[k] + dir_x_[k] * length_[k];
+        double end_y = start_y_[k] + dir_y_[k] * length_[k];
+        node.min_x = std::min({node.min_x, start_x_[k], end_x});
+        node.min_y = std::min({node.min_y, start_y_[k], end_y});
+        node.max_x = std::max({node.max_x, start_x_[k], end_x});
+        node.max_y = std::max({node.max_y, start_y_[k], end_y});
+    }
+
+    // 相邻航段在空间上也相邻，按序号对半划分即可得到紧凑的包围盒
+    if (end - begin > kLeafSegments) {
+        uint32_t middle = begin + (end - begin) / 2;
+        node.left = buildNode(begin, middle);
+        node.right = buildNode(middle, end);
+    }
+    nodes_[index] = node;
+    return index;
+}
+
+void RouteGeometry::projectOnSegment(size_t k, double px, double py, Projection& out) const {
+    double dx = px - start_x_[k];
+    double dy = py - start_y_[k];
+    double along = std::max(0.0, std::min(length_[k], dx * dir_x_[k] + dy * dir_y_[k]));
+    out.segment = k;
+    out.arc = arc_[k] + along;
+    out.offset = std::hypot(dx - along * dir_x_[k], dy - along * dir_y_[k]);
+}
+
+double RouteGeometry::boxDistanceSq(const Node& node, double px, double py) {
+    double dx = std::max({node.min_x - px, 0.0, px - node.max_x});
+    double dy = std::max({node.min_y - py, 0.0, py - node.max_y});
+    return dx * dx + dy * dy;
+}
+
+bool RouteGeometry::nearest(double px, double py, Projection& out) const {
+    if (empty()) return false;
+    double best_sq = std::numeric_limits<double>::infinity();
+    nearestIn(0, px, py, out, best_sq);
+    return true;
+}
+
+double RouteGeometry::distanceTo(double px, double py) const {
+    Projection projection;
+    if (!nearest(px, py, projection)) return std::numeric_limits<double>::infinity();
+    return projection.offset;
+}
+
+void RouteGeometry::nearestIn(int32_t index, double px, double py,
+                              Projection& best, double& best_sq) const {
+    const Node& node = nodes_[index];
+    if (boxDistanceSq(node, px, py) > best_sq) return;
+
+    if (node.left < 0) {
+        for (uint32_t k = node.begin; k < node.end; ++k) {
+            Projection candidate;
+            projectOnSegment(k, px, py, candidate);
+            double candidate_sq = candidate.offset * candidate.offset;
+            if (candidate_sq < best_sq || (candidate_sq == best_sq && k < best.segment)) {
+                best = candidate;
+                best_sq = candidate_sq;
+            }
+        }
+        return;
+    }
+
+    // 先访问包围盒较近的子节点，尽早收紧上界
+    int32_t first = node.left, second = node.right;
+    if (boxDistanceSq(nodes_[second], px, py) < boxDistanceSq(nodes_[first], px, py)) {
+        std::swap(first, second);
+    }
+    nearestIn(first, px, py, best, best_sq);
+    nearestIn(second, px, py, best, best_sq);
+}
+
+bool RouteGeometry::locate(double px, double py, double heading_x, double heading_y, double max_offset,
+                           Projection& best) const {
+    if (empty()) return false;
+    return locateIn(0, px, py, heading_x, heading_y, max_offset, best);
+}
+
+bool RouteGeometry::locateIn(int32_t index, double px, double py, double heading_x, double heading_y,
+                             double max_offset, Projection& best) const {
+    // 包围盒距离只用于剪枝，留出舍入余量，边界上的航段仍按精确距离判断
+    const Node& node = nodes_[index];
+    double reach = max_offset + 1e-9;
+    if (boxDistanceSq(node, px, py) > reach * reach) return false;
+
+    if (node.left >= 0) {
+        // 按序号先左后右，距离与方向都相同时保留序号较小的航段
+        bool found = locateIn(node.left, px, py, heading_x, heading_y, max_offset, best);
+        return locateIn(node.right, px, py, heading_x, heading_y, max_offset, best) || found;
+    }
+
+    bool found = false;
+    for (uint32_t k = node.begin; k < node.end; ++k) {
+        Projection candidate;
+        projectOnSegment(k, px, py, candidate);
+        if (candidate.offset > max_offset) continue;
+
+        candidate.aligned = heading_x * dir_x_[k] + heading_y * dir_y_[k] >= 0;
+        if ((candidate.aligned && !best.aligned) ||
+            (candidate.aligned == best.aligned && candidate.offset < best.offset)) {
+            best = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+} // namespace boat_pro
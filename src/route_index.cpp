@@ -0,0 +1,150 @@
+// ==================== src/route_index.cpp ====================
+#include "route_index.h"
+#include <algorithm>
+#include <limits>
+
+namespace boat_pro {
+
+void RouteIndex::setRoutes(const std::vector<RouteInfo>& routes) {
+    route_info_ = routes;
+    routes_.clear();
+    projected_ = false;
+}
+
+void RouteIndex::projectRoutes(const BoatSnapshot& snapshot) {
+    // 投影原点不变时航线坐标保持有效
+    if (projected_ && origin_.lat == snapshot.origin.lat && origin_.lng == snapshot.origin.lng) {
+        return;
+    }
+    origin_ = snapshot.origin;
+    projected_ = true;
+
+    routes_.clear();
+    for (const auto& route : route_info_) {
+        if (route.points.size() < 2) continue;
+
+        Polyline line;
+        line.route_id = route.route_id;
+        line.direction = route.direction;
+        line.geometry.build(route.points, snapshot.projector);
+        routes_.push_back(std::move(line));
+    }
+}
+
+void RouteIndex::build(const BoatSnapshot& snapshot, double max_offset) {
+    size_t boat_count = snapshot.size();
+    boat_positions_.assign(boat_count, BoatPosition());
+    if (route_info_.empty()) {
+        routes_.clear();
+        boats_by_arc_.clear();
+        return;
+    }
+
+    projectRoutes(snapshot);
+    boats_by_arc_.resize(routes_.size());
+    for (auto& boats : boats_by_arc_) {
+        boats.clear();
+    }
+
+    for (size_t i = 0; i < boat_count; ++i) {
+        BoatPosition& pos = boat_positions_[i];
+        if (locate(snapshot.x[i], snapshot.y[i], snapshot.hx[i], snapshot.hy[i],
+                   snapshot.route_direction[i], max_offset, pos.route, pos.arc)) {
+            boats_by_arc_[pos.route].push_back({pos.arc, i});
+        } else {
+            pos.route = -1;
+        }
+    }
+
+    // 弧长相同时按下标排序，保证前后关系确定
+    for (auto& boats : boats_by_arc_) {
+        std::sort(boats.begin(), boats.end());
+        for (size_t rank = 0; rank < boats.size(); ++rank) {
+            boat_positions_[boats[rank].second].rank = rank;
+        }
+    }
+}
+
+bool RouteIndex::locate(double px, double py, double heading_x, double heading_y,
+                        RouteDirection direction, double max_offset,
+                        int& out_route, double& out_arc) const {
+    // 优先选择切向与航向一致的航段，其次选择横向距离最近的航段，
+    // 使首尾折返、相互重叠的航段能够区分
+    RouteGeometry::Projection best;
+    best.aligned = false;
+    best.offset = std::numeric_limits<double>::infinity();
+    out_route = -1;
+
+    for (size_t r = 0; r < routes_.size(); ++r) {
+        const Polyline& line = routes_[r];
+        if (line.direction != direction) continue;
+
+        if (line.geometry.locate(px, py, heading_x, heading_y, max_offset, best)) {
+            out_route = static_cast<int>(r);
+            out_arc = best.arc;
+        }
+    }
+    return out_route >= 0;
+}
+
+bool RouteIndex::isMatched(size_t boat) const {
+    return boat < boat_positions_.size() && boat_positions_[boat].route >= 0;
+}
+
+int RouteIndex::getRouteId(size_t boat) const {
+    return isMatched(boat) ? routes_[boat_positions_[boat].route].route_id : -1;
+}
+
+double RouteIndex::getArcLength(size_t boat) const {
+    return isMatched(boat) ? boat_positions_[boat].arc : 0.0;
+}
+
+int RouteIndex::getRoute(size_t boat) const {
+    return isMatched(boat) ? boat_positions_[boat].route : -1;
+}
+
+bool RouteIndex::isOnSameRoute(size_t i, size_t j) const {
+    return isMatched(i) && isMatched(j) && boat_positions_[i].route == boat_positions_[j].route;
+}
+
+int RouteIndex::nearestAhead(size_t boat) const {
+    if (!isMatched(boat)) return kNoBoat;
+
+    const BoatPosition& pos = boat_positions_[boat];
+    const auto& boats = boats_by_arc_[pos.route];
+    if (pos.rank + 1 >= boats.size()) return kNoBoat;
+    return static_cast<int>(boats[pos.rank + 1].second);
+}
+
+int RouteIndex::nearestAheadOf(int route_id, double arc_length) const {
+    int route = findRoute(route_id);
+    if (route < 0 || static_cast<size_t>(route) >= boats_by_arc_.size()) return kNoBoat;
+
+    const auto& boats = boats_by_arc_[route];
+    auto it = std::upper_bound(boats.begin(), boats.end(), arc_length,
+                               [](double arc, const std::pair<double, size_t>& entry) {
+                                   return arc < entry.first;
+                               });
+    if (it == boats.end()) return kNoBoat;
+    return static_cast<int>(it->second);
+}
+
+int RouteIndex::nearestAheadAt(int route, double arc_length, size_t order, size_t exclude) const {
+    if (route < 0 || static_cast<size_t>(route) >= boats_by_arc_.size()) return kNoBoat;
+
+    // 与build中的排序一致：按(弧长, 下标)比较
+    const auto& boats = boats_by_arc_[route];
+    auto it = std::lower_bound(boats.begin(), boats.end(), std::make_pair(arc_length, order));
+    if (it != boats.end() && it->second == exclude) ++it;
+    if (it == boats.end()) return kNoBoat;
+    return static_cast<int>(it->second);
+}
+
+int RouteIndex::findRoute(int route_id) const {
+    for (size_t r = 0; r < routes_.size(); ++r) {
+        if (routes_[r].route_id == route_id) return static_cast<int>(r);
+    }
+    return -1;
+}
+
+} // namespace boat_pro
@@ -0,0 +1,129 @@
+// ==================== src/spatial_hash_grid.cpp ====================
+#include "spatial_hash_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace boat_pro {
+
+SpatialHashGrid::SpatialHashGrid() : cell_size_(1.0), cell_shift_(64) {
+}
+
+void SpatialHashGrid::rebuild(double cell_size, const std::vector<int>& ids,
+                              const std::vector<double>& xs, const std::vector<double>& ys) {
+    clear();
+    cell_size_ = cell_size > 0 ? cell_size : 1.0;
+
+    entries_.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        entries_.push_back({cellKey(cellCoord(xs[i]), cellCoord(ys[i])), ids[i]});
+    }
+
+    // 按单元键排序，使同一单元内的对象连续存放
+    std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+        return a.key < b.key || (a.key == b.key && a.id < b.id);
+    });
+
+    if (entries_.empty()) return;
+
+    // 哈希表容量不小于非空单元数的2倍；容器只清零不释放，重建时复用
+    size_t cell_count = 1;
+    for (size_t i = 1; i < entries_.size(); ++i) {
+        if (entries_[i].key != entries_[i - 1].key) ++cell_count;
+    }
+    size_t capacity = 16;
+    cell_shift_ = 60;
+    while (capacity < cell_count * 2) {
+        capacity *= 2;
+        --cell_shift_;
+    }
+    cells_.assign(capacity, Cell{0, 0, 0});
+
+    uint32_t begin = 0;
+    for (uint32_t i = 1; i <= entries_.size(); ++i) {
+        if (i == entries_.size() || entries_[i].key != entries_[begin].key) {
+            insertCell(entries_[begin].key, begin, i);
+            begin = i;
+        }
+    }
+}
+
+void SpatialHashGrid::rebuild(double cell_size, const std::vector<double>& xs,
+                              const std::vector<double>& ys) {
+    index_ids_.resize(xs.size());
+    for (size_t i = 0; i < index_ids_.size(); ++i) {
+        index_ids_[i] = static_cast<int>(i);
+    }
+    rebuild(cell_size, index_ids_, xs, ys);
+}
+
+void SpatialHashGrid::clear() {
+    entries_.clear();
+    cells_.clear();
+    cell_shift_ = 64;
+}
+
+void SpatialHashGrid::queryNeighbors(double x, double y, std::vector<int>& out) const {
+    int32_t cx = cellCoord(x);
+    int32_t cy = cellCoord(y);
+
+    for (int32_t dx = -1; dx <= 1; ++dx) {
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            const Cell* cell = findCell(cellKey(cx + dx, cy + dy));
+            if (cell == nullptr) continue;
+
+            for (uint32_t i = cell->begin; i < cell->end; ++i) {
+                out.push_back(entries_[i].id);
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::queryRange(double x, double y, double range, std::vector<int>& out) const {
+    int32_t rings = std::max<int32_t>(1, static_cast<int32_t>(std::ceil(range / cell_size_)));
+    int32_t cx = cellCoord(x);
+    int32_t cy = cellCoord(y);
+
+    for (int32_t dx = -rings; dx <= rings; ++dx) {
+        for (int32_t dy = -rings; dy <= rings; ++dy) {
+            const Cell* cell = findCell(cellKey(cx + dx, cy + dy));
+            if (cell == nullptr) continue;
+
+            for (uint32_t i = cell->begin; i < cell->end; ++i) {
+                out.push_back(entries_[i].id);
+            }
+        }
+    }
+}
+
+int32_t SpatialHashGrid::cellCoord(double v) const {
+    return static_cast<int32_t>(std::floor(v / cell_size_));
+}
+
+uint64_t SpatialHashGrid::cellKey(int32_t cx, int32_t cy) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+           static_cast<uint64_t>(static_cast<uint32_t>(cy));
+}
+
+const SpatialHashGrid::Cell* SpatialHashGrid::findCell(uint64_t key) const {
+    if (cells_.empty()) return nullptr;
+
+    // 斐波那契散列取高位，相邻单元键分散到不同槽位
+    size_t mask = cells_.size() - 1;
+    size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> cell_shift_);
+    while (cells_[slot].end != 0) {
+        if (cells_[slot].key == key) return &cells_[slot];
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
+
+void SpatialHashGrid::insertCell(uint64_t key, uint32_t begin, uint32_t end) {
+    size_t mask = cells_.size() - 1;
+    size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> cell_shift_);
+    while (cells_[slot].end != 0) {
+        slot = (slot + 1) & mask;
+    }
+    cells_[slot] = {key, begin, end};
+}
+
+} // namespace boat_pro
@@ -0,0 +1,133 @@
+// ==================== src/thread_pool.cpp ====================
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace boat_pro {
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t worker_count)
+    : current_fn_(nullptr), generation_(0), active_workers_(0),
+      stopping_(false), remaining_tasks_(0) {
+    worker_count = std::max<size_t>(1, worker_count);
+    for (size_t w = 0; w < worker_count; ++w) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    // 0号工作者为调用线程，只为其余工作者创建线程
+    for (size_t w = 1; w < worker_count; ++w) {
+        threads_.emplace_back(&WorkStealingThreadPool::workerLoop, this, w);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void WorkStealingThreadPool::parallelFor(size_t task_count, const TaskFunction& fn) {
+    if (task_count == 0) return;
+
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+
+    if (threads_.empty()) {
+        for (size_t task = 0; task < task_count; ++task) fn(task, 0);
+        return;
+    }
+
+    // 按连续区间预分配到各工作者队列，保持数据局部性
+    size_t worker_count = queues_.size();
+    for (size_t w = 0; w < worker_count; ++w) {
+        size_t begin = task_count * w / worker_count;
+        size_t end = task_count * (w + 1) / worker_count;
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        for (size_t task = begin; task < end; ++task) {
+            queues_[w]->tasks.push_back(task);
+        }
+    }
+
+    remaining_tasks_.store(task_count, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_fn_ = &fn;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    runTasks(0, fn);
+
+    // 等待所有任务完成且没有工作者仍持有本批任务函数
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] {
+        return remaining_tasks_.load(std::memory_order_acquire) == 0 && active_workers_ == 0;
+    });
+    current_fn_ = nullptr;
+}
+
+void WorkStealingThreadPool::workerLoop(size_t worker) {
+    uint64_t seen_generation = 0;
+
+    while (true) {
+        const TaskFunction* fn = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) return;
+
+            seen_generation = generation_;
+            fn = current_fn_;
+            if (fn == nullptr) continue;  // 本批任务已经结束
+            ++active_workers_;
+        }
+
+        runTasks(worker, *fn);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_workers_;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void WorkStealingThreadPool::runTasks(size_t worker, const TaskFunction& fn) {
+    size_t task;
+    while (popTask(worker, task)) {
+        fn(task, worker);
+        if (remaining_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_cv_.notify_all();
+        }
+    }
+}
+
+bool WorkStealingThreadPool::popTask(size_t worker, size_t& task) {
+    // 优先从自己队列头部按顺序取任务
+    {
+        WorkerQueue& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // 自己的队列为空时，从其他工作者队列尾部窃取
+    size_t worker_count = queues_.size();
+    for (size_t offset = 1; offset < worker_count; ++offset) {
+        WorkerQueue& victim = *queues_[(worker + offset) % worker_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace boat_pro
@@ -1,5 +1,9 @@
 // ==================== src/types.cpp ====================
 #include "types.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_set>
 
 namespace boat_pro {
 
@@ -45,6 +49,66 @@ BoatState BoatState::fromJson(const Json::Value& json) {
     return boat;
 }
 
+// PackedBoatState implementations
+PackedBoatState PackedBoatState::pack(const BoatState& boat) {
+    PackedBoatState packed;
+    packed.timestamp = boat.timestamp;
+    packed.sysid = boat.sysid;
+    packed.lat_e7 = static_cast<int32_t>(std::lround(boat.lat * kDegreeScale));
+    packed.lng_e7 = static_cast<int32_t>(std::lround(boat.lng * kDegreeScale));
+
+    // 航向归一化到[0, 360)后取整，取整到360度时回绕为0
+    long heading = std::lround(std::fmod(std::fmod(boat.heading, 360.0) + 360.0, 360.0) * kHeadingScale);
+    packed.heading_cdeg = static_cast<uint16_t>(heading >= 36000 ? heading - 36000 : heading);
+
+    long speed = std::lround(boat.speed * kSpeedScale);
+    packed.speed_cms = static_cast<int16_t>(std::max<long>(INT16_MIN, std::min<long>(INT16_MAX, speed)));
+    packed.flags = static_cast<uint8_t>((static_cast<int>(boat.status) & 0x3) |
+                                        ((static_cast<int>(boat.route_direction) & 0x3) << 2));
+    return packed;
+}
+
+BoatState PackedBoatState::unpack() const {
+    BoatState boat;
+    boat.sysid = sysid;
+    boat.timestamp = timestamp;
+    boat.lat = getLat();
+    boat.lng = getLng();
+    boat.heading = getHeading();
+    boat.speed = getSpeed();
+    boat.status = getStatus();
+    boat.route_direction = getRouteDirection();
+    return boat;
+}
+
+std::vector<PackedBoatState> packBoatStates(const std::vector<BoatState>& boats) {
+    std::vector<PackedBoatState> packed;
+    packed.reserve(boats.size());
+    for (const auto& boat : boats) {
+        packed.push_back(PackedBoatState::pack(boat));
+    }
+
+    // 稳定排序后同一ID的记录保持输入顺序，保留最后一条
+    std::stable_sort(packed.begin(), packed.end(),
+                     [](const PackedBoatState& a, const PackedBoatState& b) { return a.sysid < b.sysid; });
+    size_t kept = 0;
+    for (size_t k = 0; k < packed.size(); ++k) {
+        if (kept > 0 && packed[kept - 1].sysid == packed[k].sysid) {
+            packed[kept - 1] = packed[k];
+        } else {
+            packed[kept++] = packed[k];
+        }
+    }
+    packed.resize(kept);
+    return packed;
+}
+
+const PackedBoatState* findPackedBoat(const std::vector<PackedBoatState>& boats, int sysid) {
+    auto it = std::lower_bound(boats.begin(), boats.end(), sysid,
+                               [](const PackedBoatState& boat, int id) { return boat.sysid < id; });
+    return it != boats.end() && it->sysid == sysid ? &*it : nullptr;
+}
+
 // 实例方法版本
 void BoatState::loadFromJson(const Json::Value& json) {
     sysid = json["sysid"].asInt();
@@ -111,6 +175,11 @@ Json::Value SystemConfig::toJson() const {
     json["warning_threshold_s"] = warning_threshold_s;
     json["max_boats"] = max_boats;
     json["min_route_gap_m"] = min_route_gap_m;
+    json["detection_threads"] = detection_threads;
+    json["alert_hysteresis_s"] = alert_hysteresis_s;
+    json["dock_corridor_radius_m"] = dock_corridor_radius_m;
+    json["detection_shards"] = detection_shards;
+    json["fast_trig"] = fast_trig;
     return json;
 }
 
@@ -122,6 +191,11 @@ SystemConfig SystemConfig::fromJson(const Json::Value& json) {
     config.warning_threshold_s = json["warning_threshold_s"].asDouble();
     config.max_boats = json["max_boats"].asInt();
     config.min_route_gap_m = json["min_route_gap_m"].asDouble();
+    config.detection_threads = json.get("detection_threads", 0).asInt();
+    config.alert_hysteresis_s = json.get("alert_hysteresis_s", 1.0).asDouble();
+    config.dock_corridor_radius_m = json.get("dock_corridor_radius_m", 20.0).asDouble();
+    config.detection_shards = json.get("detection_shards", 1).asInt();
+    config.fast_trig = json.get("fast_trig", false).asBool();
     return config;
 }
 
@@ -133,6 +207,11 @@ void SystemConfig::loadFromJson(const Json::Value& json) {
     warning_threshold_s = json["warning_threshold_s"].asDouble();
     max_boats = json["max_boats"].asInt();
     min_route_gap_m = json["min_route_gap_m"].asDouble();
+    detection_threads = json.get("detection_threads", 0).asInt();
+    alert_hysteresis_s = json.get("alert_hysteresis_s", 1.0).asDouble();
+    dock_corridor_radius_m = json.get("dock_corridor_radius_m", 20.0).asDouble();
+    detection_shards = json.get("detection_shards", 1).asInt();
+    fast_trig = json.get("fast_trig", false).asBool();
 }
 
 SystemConfig SystemConfig::getDefault() {
@@ -143,9 +222,84 @@ SystemConfig SystemConfig::getDefault() {
     config.warning_threshold_s = 30.0;
     config.max_boats = 30;
     config.min_route_gap_m = 10.0;
+    config.detection_threads = 0;
+    config.alert_hysteresis_s = 1.0;
+    config.dock_corridor_radius_m = 20.0;
+    config.detection_shards = 1;
+    config.fast_trig = false;
     return config;
 }
 
+// BoatIdList implementations
+BoatIdList::BoatIdList(std::initializer_list<int> ids) {
+    for (int id : ids) push_back(id);
+}
+
+BoatIdList::BoatIdList(const std::vector<int>& ids) {
+    for (int id : ids) push_back(id);
+}
+
+void BoatIdList::push_back(int id) {
+    if (size_ < kInlineCapacity) {
+        inline_ids_[size_++] = id;
+        return;
+    }
+    if (size_ == kInlineCapacity) {
+        overflow_.assign(inline_ids_, inline_ids_ + kInlineCapacity);
+    }
+    overflow_.push_back(id);
+    ++size_;
+}
+
+void BoatIdList::clear() {
+    size_ = 0;
+    overflow_.clear();
+}
+
+bool operator==(const BoatIdList& a, const BoatIdList& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+bool operator==(const BoatIdList& a, const std::vector<int>& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+// InternedString implementations
+namespace {
+
+const std::string* emptyInternedText() {
+    static const std::string empty_text;
+    return &empty_text;
+}
+
+} // namespace
+
+InternedString::InternedString() : text_(emptyInternedText()) {
+}
+
+InternedString::InternedString(const std::string& text) : text_(intern(text)) {
+}
+
+InternedString::InternedString(const char* text) : text_(intern(text)) {
+}
+
+void InternedString::clear() {
+    text_ = emptyInternedText();
+}
+
+const std::string* InternedString::intern(const std::string& text) {
+    if (text.empty()) return emptyInternedText();
+    
+    // 节点式容器中元素地址不随插入改变；已驻留的字符串只查找不分配
+    static std::mutex pool_mutex;
+    static std::unordered_set<std::string> pool;
+    
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    auto it = pool.find(text);
+    if (it == pool.end()) it = pool.insert(text).first;
+    return &*it;
+}
+
 // CollisionAlert implementations
 Json::Value CollisionAlert::toJson() const {
     Json::Value json;
@@ -168,9 +322,19 @@ Json::Value CollisionAlert::toJson() const {
     json["collision_time"] = collision_time;
     json["current_heading"] = current_heading;
     json["other_heading"] = other_heading;
-    json["decision_advice"] = decision_advice;
+    json["decision_advice"] = decision_advice.str();
+    json["type"] = static_cast<int>(type);
+    json["alert_id"] = static_cast<Json::UInt64>(alert_id);
     
     return json;
 }
 
+// AlertDelta implementations
+Json::Value AlertDelta::toJson() const {
+    Json::Value json = alert.toJson();
+    json["event"] = static_cast<int>(event);
+    json["previous_level"] = static_cast<int>(previous_level);
+    return json;
+}
+
 } // namespace boat_pro
@@ -1,11 +1,50 @@
 #include "../src/collision_detector.cpp"
+#include "../src/pair_cache.cpp"
+#include "../src/recheck_schedule.cpp"
+#include "../src/pair_priority_queue.cpp"
+#include "../src/kinetic_tracker.cpp"
+#include "../src/alert_table.cpp"
 #include "../src/types.cpp"
 #include "../src/geometry_utils.cpp"
+#include "../src/local_projector.cpp"
+#include "../src/spatial_hash_grid.cpp"
+#include "../src/boat_snapshot.cpp"
+#include "../src/collision_kernel.cpp"
+#include "../src/thread_pool.cpp"
+#include "../src/route_index.cpp"
+#include "../src/route_geometry.cpp"
+#include "../src/harbor_rtree.cpp"
+#include "../src/dock_corridor_index.cpp"
 #include <iostream>
 #include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <new>
+#include <random>
 
 using namespace boat_pro;
 
+// 全局堆分配计数，用于验证检测热路径在稳定状态下不分配内存
+static std::atomic<size_t> g_allocation_count(0);
+
+// 不内联，避免编译器把malloc与operator delete配对时误报不匹配
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    ++g_allocation_count;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
 void testGeometryUtils() {
     std::cout << "测试几何工具函数..." << std::endl;
     
@@ -25,6 +64,241 @@ void testGeometryUtils() {
     std::cout << "几何工具函数测试通过!" << std::endl;
 }
 
+void testBatchGeometry() {
+    std::cout << "测试批量几何函数..." << std::endl;
+
+    // 原点周围约2公里内的随机点，另加与原点重合、正东与正西的点
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<double> offset(-0.02, 0.02);
+    GeoPoint origin(30.5490, 114.3420);
+    std::vector<double> lats = {origin.lat, origin.lat, origin.lat};
+    std::vector<double> lngs = {origin.lng, origin.lng + 0.001, origin.lng - 0.001};
+    for (int k = 0; k < 4096; ++k) {
+        lats.push_back(origin.lat + offset(rng));
+        lngs.push_back(origin.lng + offset(rng));
+    }
+    size_t count = lats.size();
+
+    std::vector<double> distances(count), bearings(count);
+    geometry::calculateDistances(origin, lats.data(), lngs.data(), count, distances.data());
+    geometry::calculateBearings(origin, lats.data(), lngs.data(), count, bearings.data());
+    for (size_t k = 0; k < count; ++k) {
+        GeoPoint point(lats[k], lngs[k]);
+        assert(std::abs(distances[k] - geometry::calculateDistance(origin, point)) < 1e-9);
+        assert(std::abs(bearings[k] - geometry::calculateBearing(origin, point)) < 1e-9);
+        assert(bearings[k] >= 0 && bearings[k] < 360);
+    }
+
+    // 按各自方位角与距离原地推进，结果与逐点计算一致
+    std::vector<double> steps(count);
+    for (size_t k = 0; k < count; ++k) steps[k] = 0.5 * k;
+    std::vector<double> next_lats = lats, next_lngs = lngs;
+    geometry::calculateDestinations(next_lats.data(), next_lngs.data(), bearings.data(),
+                                    steps.data(), count, next_lats.data(), next_lngs.data());
+    for (size_t k = 0; k < count; ++k) {
+        GeoPoint expected = geometry::calculateDestination(GeoPoint(lats[k], lngs[k]),
+                                                           bearings[k], steps[k]);
+        assert(std::abs(next_lats[k] - expected.lat) < 1e-12);
+        assert(std::abs(next_lngs[k] - expected.lng) < 1e-12);
+    }
+
+    // 与逐点调用对比耗时
+    const int rounds = 200;
+    double checksum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (size_t k = 0; k < count; ++k) {
+            distances[k] = geometry::calculateDistance(origin, GeoPoint(lats[k], lngs[k]));
+        }
+        checksum += distances[round];
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        geometry::calculateDistances(origin, lats.data(), lngs.data(), count, distances.data());
+        checksum -= distances[round];
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "逐点测距耗时: "
+              << std::chrono::duration<double, std::milli>(middle - start).count()
+              << " 毫秒, 批量测距耗时: "
+              << std::chrono::duration<double, std::milli>(end - middle).count()
+              << " 毫秒 (" << count << " 点 x " << rounds << " 轮)" << std::endl;
+    assert(std::abs(checksum) < 1e-6);
+
+    std::cout << "批量几何函数测试通过!" << std::endl;
+}
+
+void testLocalProjector() {
+    std::cout << "测试局部切平面投影..." << std::endl;
+
+    GeoPoint origin(30.5490, 114.3420);
+    geometry::LocalProjector projector(origin);
+    double x, y;
+    projector.project(origin.lat, origin.lng, x, y);
+    assert(x == 0.0 && y == 0.0);
+
+    // 原点周围约5公里内：投影距离与大圆距离的偏差小于一阶等距投影
+    std::mt19937 rng(22);
+    std::uniform_real_distribution<double> offset(-0.045, 0.045);
+    double meters_per_deg_lat = geometry::EARTH_RADIUS * M_PI / 180.0;
+    double meters_per_deg_lng = meters_per_deg_lat * std::cos(geometry::toRadians(origin.lat));
+    double max_error = 0.0, max_first_order_error = 0.0, max_round_trip = 0.0;
+    for (int k = 0; k < 2000; ++k) {
+        GeoPoint a(origin.lat + offset(rng), origin.lng + offset(rng));
+        GeoPoint b(origin.lat + offset(rng), origin.lng + offset(rng));
+        double ax, ay, bx, by;
+        projector.project(a.lat, a.lng, ax, ay);
+        projector.project(b.lat, b.lng, bx, by);
+        double expected = geometry::calculateDistance(a, b);
+        max_error = std::max(max_error, std::abs(std::hypot(bx - ax, by - ay) - expected));
+
+        double dx = (b.lng - a.lng) * meters_per_deg_lng;
+        double dy = (b.lat - a.lat) * meters_per_deg_lat;
+        max_first_order_error = std::max(max_first_order_error,
+                                         std::abs(std::hypot(dx, dy) - expected));
+
+        // 反投影与投影互逆
+        GeoPoint back = projector.unproject(ax, ay);
+        max_round_trip = std::max(max_round_trip,
+                                  geometry::calculateDistance(a, back));
+    }
+    std::cout << "投影距离最大偏差: " << max_error << " 米(一阶等距投影 "
+              << max_first_order_error << " 米), 往返最大偏差: " << max_round_trip
+              << " 米" << std::endl;
+    assert(max_error < max_first_order_error);
+    assert(max_error < 1.0);
+    assert(max_round_trip < 1e-4);
+
+    // 平移：向东北各100米后与起点的距离与方位
+    GeoPoint start(30.5600, 114.3300);
+    GeoPoint moved = projector.translate(start, 100.0, 100.0);
+    assert(std::abs(geometry::calculateDistance(start, moved) - 100.0 * std::sqrt(2.0)) < 0.05);
+    assert(std::abs(geometry::calculateBearing(start, moved) - 45.0) < 0.1);
+
+    // 共用投影的碰撞时间与逐次构造投影的结果一致
+    GeoPoint pos1(30.5490, 114.3420), pos2(30.5490, 114.3430);
+    GeoPoint vel1(0.0, 1e-5), vel2(0.0, -1e-5);
+    geometry::LocalProjector at_pos1(pos1);
+    double t = geometry::calculateCollisionTime(pos1, vel1, pos2, vel2, 5.0);
+    assert(t > 0);
+    assert(t == geometry::calculateCollisionTime(at_pos1, pos1, vel1, pos2, vel2, 5.0));
+
+    std::cout << "局部切平面投影测试通过!" << std::endl;
+}
+
+void testFastTrig() {
+    std::cout << "测试快速近似三角函数..." << std::endl;
+
+    // 基本函数与标准库的最大误差
+    double sin_error = 0.0, atan2_error = 0.0, asin_error = 0.0;
+    for (double x = -100.0; x <= 100.0; x += 0.000731) {
+        double s, c;
+        geometry::fast::sincos(x, s, c);
+        sin_error = std::max({sin_error, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+    }
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (int k = 0; k < 200000; ++k) {
+        double y = unit(rng), x = unit(rng);
+        atan2_error = std::max(atan2_error, std::abs(geometry::fast::atan2(y, x) - std::atan2(y, x)));
+        asin_error = std::max(asin_error, std::abs(geometry::fast::asin(y) - std::asin(y)));
+    }
+    std::cout << "sin/cos最大误差: " << sin_error << ", atan2最大误差: " << atan2_error
+              << " 弧度, asin最大误差: " << asin_error << " 弧度" << std::endl;
+    assert(sin_error < 1e-10);
+    assert(atan2_error < 5e-10);
+    assert(asin_error < 5e-10);
+    assert(geometry::fast::atan2(0.0, -1.0) == M_PI);
+    assert(geometry::fast::asin(1.0) == M_PI / 2);
+
+    // 港区纬度范围内(约30公里见方)的距离、方位角与目标点误差
+    std::uniform_real_distribution<double> lat_dist(30.40, 30.70);
+    std::uniform_real_distribution<double> lng_dist(114.20, 114.50);
+    std::uniform_real_distribution<double> bearing_dist(0.0, 360.0);
+    std::uniform_real_distribution<double> step_dist(0.0, 2000.0);
+    const size_t count = 20000;
+    GeoPoint origin(30.5490, 114.3420);
+    std::vector<double> lats(count), lngs(count), bearings(count), steps(count);
+    for (size_t k = 0; k < count; ++k) {
+        lats[k] = lat_dist(rng);
+        lngs[k] = lng_dist(rng);
+        bearings[k] = bearing_dist(rng);
+        steps[k] = step_dist(rng);
+    }
+
+    std::vector<double> exact_distances(count), fast_distances(count);
+    std::vector<double> exact_bearings(count), fast_bearings(count);
+    std::vector<double> exact_lats(count), exact_lngs(count), fast_lats(count), fast_lngs(count);
+    auto run = [&](geometry::TrigMode mode, std::vector<double>& distances, std::vector<double>& out_bearings,
+                   std::vector<double>& out_lats, std::vector<double>& out_lngs) {
+        geometry::calculateDistances(mode, origin, lats.data(), lngs.data(), count, distances.data());
+        geometry::calculateBearings(mode, origin, lats.data(), lngs.data(), count, out_bearings.data());
+        geometry::calculateDestinations(mode, lats.data(), lngs.data(), bearings.data(), steps.data(),
+                                        count, out_lats.data(), out_lngs.data());
+    };
+    run(geometry::TrigMode::EXACT, exact_distances, exact_bearings, exact_lats, exact_lngs);
+    run(geometry::TrigMode::FAST, fast_distances, fast_bearings, fast_lats, fast_lngs);
+
+    // 方位角由相近量相减得到，目标点离原点很近时角度误差放大，按横向偏移(角度误差x距离)评估
+    double distance_error = 0.0, bearing_error = 0.0, cross_track_error = 0.0, position_error = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        distance_error = std::max(distance_error, std::abs(fast_distances[k] - exact_distances[k]));
+        double angle_error = geometry::angleDifference(fast_bearings[k], exact_bearings[k]);
+        bearing_error = std::max(bearing_error, angle_error);
+        cross_track_error = std::max(cross_track_error,
+                                     geometry::toRadians(angle_error) * exact_distances[k]);
+        position_error = std::max(position_error, geometry::calculateDistance(
+            GeoPoint(exact_lats[k], exact_lngs[k]), GeoPoint(fast_lats[k], fast_lngs[k])));
+    }
+    std::cout << "港区范围最大误差: 距离 " << distance_error << " 米, 方位角 " << bearing_error
+              << " 度(横向偏移 " << cross_track_error << " 米), 目标点位置 " << position_error
+              << " 米" << std::endl;
+    assert(distance_error < 0.01);
+    assert(cross_track_error < 0.01);
+    assert(position_error < 0.01);
+
+    // 标量接口与批量接口一致(批量接口可能使用AVX2与FMA，末位舍入可以不同)；
+    // 点数不是4的倍数时尾部由标量实现处理
+    std::vector<double> tail(count - 1);
+    geometry::calculateDistances(geometry::TrigMode::FAST, origin, lats.data(), lngs.data(),
+                                 count - 1, tail.data());
+    for (size_t k = 0; k < count - 1; k += 997) {
+        GeoPoint point(lats[k], lngs[k]);
+        assert(std::abs(geometry::calculateDistance(geometry::TrigMode::FAST, origin, point) -
+                        tail[k]) < 1e-6);
+        assert(geometry::calculateDistance(geometry::TrigMode::EXACT, origin, point) ==
+               geometry::calculateDistance(origin, point));
+    }
+    assert(std::abs(tail.back() - exact_distances[count - 2]) < 0.01);
+    GeoPoint moved = geometry::calculateDestination(geometry::TrigMode::FAST, GeoPoint(lats[0], lngs[0]),
+                                                    bearings[0], steps[0]);
+    assert(std::abs(moved.lat - fast_lats[0]) < 1e-9 && std::abs(moved.lng - fast_lngs[0]) < 1e-9);
+    assert(std::abs(geometry::calculateBearing(geometry::TrigMode::FAST, origin, GeoPoint(lats[0], lngs[0])) -
+                    fast_bearings[0]) < 1e-6);
+
+    // 吞吐量对比
+    const int rounds = 50;
+    double elapsed_ms[2] = {0.0, 0.0};
+    for (int mode = 0; mode < 2; ++mode) {
+        auto trig_mode = static_cast<geometry::TrigMode>(mode);
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            if (trig_mode == geometry::TrigMode::EXACT) {
+                run(trig_mode, exact_distances, exact_bearings, exact_lats, exact_lngs);
+            } else {
+                run(trig_mode, fast_distances, fast_bearings, fast_lats, fast_lngs);
+            }
+        }
+        elapsed_ms[mode] = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    std::cout << "距离+方位角+目标点 " << count << " 点 x " << rounds << " 轮: 标准库 "
+              << elapsed_ms[0] << " 毫秒, 快速近似 " << elapsed_ms[1] << " 毫秒 (加速 "
+              << elapsed_ms[0] / elapsed_ms[1] << " 倍)" << std::endl;
+
+    std::cout << "快速近似三角函数测试通过!" << std::endl;
+}
+
 void testCollisionDetector() {
     std::cout << "测试碰撞检测器..." << std::endl;
     
@@ -67,12 +341,1527 @@ void testCollisionDetector() {
     std::cout << "碰撞检测器测试完成!" << std::endl;
 }
 
+// 生成港区内随机分布的船队
+std::vector<BoatState> createRandomFleet(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> lat_dist(30.546, 30.552);
+    std::uniform_real_distribution<double> lng_dist(114.339, 114.346);
+    std::uniform_real_distribution<double> heading_dist(0.0, 360.0);
+    std::uniform_real_distribution<double> speed_dist(0.0, 4.0);
+    std::uniform_int_distribution<int> status_dist(1, 3);
+    std::uniform_int_distribution<int> route_dist(1, 2);
+    
+    std::vector<BoatState> boats;
+    for (int i = 0; i < count; ++i) {
+        BoatState boat;
+        boat.sysid = i + 1;
+        boat.timestamp = 1722325256.530;
+        boat.lat = lat_dist(rng);
+        boat.lng = lng_dist(rng);
+        boat.heading = heading_dist(rng);
+        boat.speed = speed_dist(rng);
+        boat.status = static_cast<BoatStatus>(status_dist(rng));
+        boat.route_direction = static_cast<RouteDirection>(route_dist(rng));
+        boats.push_back(boat);
+    }
+    return boats;
+}
+
+// 参考实现：逐类型四次两两遍历(融合遍历之前的检测逻辑)，用于校验融合遍历结果
+// extrapolate为true时各船在局部平面上按上报时间戳匀速外推到now时刻(动态检测的语义)
+std::vector<CollisionAlert> referenceDetect(const std::vector<BoatState>& input,
+                                            const SystemConfig& config,
+                                            bool extrapolate = false, double now = 0.0) {
+    // 检测器按紧凑记录的定点精度保存状态，参考实现使用同样取整后的输入
+    std::map<int, BoatState> boats;
+    for (const auto& boat : input) boats[boat.sysid] = PackedBoatState::pack(boat).unpack();
+    
+    const double radius = config.boat.length * 2.0;
+    const geometry::LocalProjector projector(boats.begin()->second.getPosition());
+    
+    // 与快照相同，以ID最小船只为原点投影到局部平面，速度按航向分解为东/北分量(m/s)
+    struct Planar { double x, y, vx, vy; };
+    std::map<int, Planar> planar;
+    for (const auto& [id, boat] : boats) {
+        Planar p;
+        projector.project(boat.lat, boat.lng, p.x, p.y);
+        p.vx = boat.speed * std::sin(geometry::toRadians(boat.heading));
+        p.vy = boat.speed * std::cos(geometry::toRadians(boat.heading));
+        if (extrapolate) {
+            p.x += p.vx * (now - boat.timestamp);
+            p.y += p.vy * (now - boat.timestamp);
+        }
+        planar[id] = p;
+    }
+    auto level_of = [&](double t) {
+        if (t <= config.emergency_threshold_s) return AlertLevel::EMERGENCY;
+        if (t <= config.warning_threshold_s) return AlertLevel::WARNING;
+        return AlertLevel::NORMAL;
+    };
+    auto relevant = [&](double t) { return t > 0 && t <= config.warning_threshold_s; };
+    auto oncoming = [](const BoatState& a, const BoatState& b) {
+        if (a.route_direction == b.route_direction) return false;
+        double diff = geometry::angleDifference(a.heading, b.heading);
+        return diff > 135.0 && diff < 225.0;
+    };
+    auto time_of = [&](const BoatState& a, const BoatState& b) {
+        const Planar& pa = planar[a.sysid];
+        const Planar& pb = planar[b.sysid];
+        return geometry::calculateCollisionTime(pb.x - pa.x, pb.y - pa.y,
+                                                pb.vx - pa.vx, pb.vy - pa.vy, radius);
+    };
+    auto bearing_of = [&](const BoatState& a, const BoatState& b) {
+        if (!extrapolate) return geometry::calculateBearing(a.getPosition(), b.getPosition());
+        const Planar& pa = planar[a.sysid];
+        const Planar& pb = planar[b.sysid];
+        return geometry::normalizeAngle(geometry::toDegrees(std::atan2(pb.x - pa.x, pb.y - pa.y)));
+    };
+    auto advice_of = [](const CollisionAlert& alert) {
+        std::string advice;
+        if (alert.level == AlertLevel::EMERGENCY) return std::string("紧急停船！");
+        if (!alert.oncoming_boat_ids.empty()) advice += "对向来船，建议减速并向右避让；";
+        if (!alert.front_boat_ids.empty()) advice += "前方有船，建议减速或停船等待；";
+        return advice;
+    };
+    
+    std::vector<CollisionAlert> undocking, docking, following, oncoming_alerts;
+    for (const auto& [id, boat] : boats) {
+        CollisionAlert alert;
+        alert.current_boat_id = id;
+        alert.level = AlertLevel::NORMAL;
+        double min_time = std::numeric_limits<double>::max();
+        int closest = -1;
+        CollisionAlert onc = alert;
+        double onc_min = min_time;
+        
+        for (const auto& [other_id, other] : boats) {
+            if (other_id == id) continue;
+            double t = time_of(boat, other);
+            if (!relevant(t)) continue;
+            
+            if (boat.status == BoatStatus::UNDOCKING && t < min_time) {
+                min_time = t;
+                if (other.status != BoatStatus::UNDOCKING) {
+                    alert.level = level_of(t);
+                    if (oncoming(boat, other)) alert.oncoming_boat_ids.push_back(other_id);
+                    else alert.front_boat_ids.push_back(other_id);
+                }
+            } else if (boat.status == BoatStatus::DOCKING &&
+                       boat.route_direction == other.route_direction && t < min_time) {
+                min_time = t;
+                alert.level = level_of(t);
+                alert.front_boat_ids.push_back(other_id);
+            } else if (boat.status == BoatStatus::NORMAL_SAIL) {
+                if (boat.route_direction == other.route_direction) {
+                    double bearing = bearing_of(boat, other);
+                    if (geometry::angleDifference(boat.heading, bearing) < 45.0 && t < min_time) {
+                        min_time = t;
+                        closest = other_id;
+                        alert.level = level_of(t);
+                    }
+                } else if (oncoming(boat, other) && t < onc_min) {
+                    onc_min = t;
+                    onc.level = level_of(t);
+                    onc.oncoming_boat_ids.push_back(other_id);
+                }
+            }
+        }
+        
+        alert.collision_time = min_time;
+        onc.collision_time = onc_min;
+        if (boat.status == BoatStatus::NORMAL_SAIL) {
+            if (alert.level != AlertLevel::NORMAL && closest != -1) {
+                alert.front_boat_ids.push_back(closest);
+                alert.decision_advice = advice_of(alert);
+                following.push_back(alert);
+            }
+            if (onc.level != AlertLevel::NORMAL) {
+                onc.decision_advice = advice_of(onc);
+                oncoming_alerts.push_back(onc);
+            }
+        } else if (alert.level != AlertLevel::NORMAL) {
+            alert.decision_advice = advice_of(alert);
+            (boat.status == BoatStatus::UNDOCKING ? undocking : docking).push_back(alert);
+        }
+    }
+    
+    std::vector<CollisionAlert> alerts = undocking;
+    alerts.insert(alerts.end(), docking.begin(), docking.end());
+    alerts.insert(alerts.end(), following.begin(), following.end());
+    alerts.insert(alerts.end(), oncoming_alerts.begin(), oncoming_alerts.end());
+    return alerts;
+}
+
+void assertSameAlerts(const std::vector<CollisionAlert>& a, const std::vector<CollisionAlert>& b,
+                      double time_tolerance = 1e-6) {
+    assert(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(a[i].current_boat_id == b[i].current_boat_id);
+        assert(a[i].level == b[i].level);
+        assert(std::abs(a[i].collision_time - b[i].collision_time) <= time_tolerance);
+        assert(a[i].front_boat_ids == b[i].front_boat_ids);
+        assert(a[i].oncoming_boat_ids == b[i].oncoming_boat_ids);
+        assert(a[i].decision_advice == b[i].decision_advice);
+    }
+}
+
+void testPackedBoatState() {
+    std::cout << "测试紧凑船只记录..." << std::endl;
+    
+    static_assert(sizeof(PackedBoatState) <= 32, "紧凑记录超过32字节");
+    auto boats = createRandomFleet(10000, 5);
+    boats[0].heading = 359.999;
+    boats[1].heading = -90.0;
+    boats[2].status = BoatStatus::DOCKING;
+    boats[2].route_direction = RouteDirection::COUNTERCLOCKWISE;
+    
+    // 转换误差不超过半个定点单位
+    for (const auto& boat : boats) {
+        BoatState restored = PackedBoatState::pack(boat).unpack();
+        assert(restored.sysid == boat.sysid);
+        assert(restored.timestamp == boat.timestamp);
+        assert(std::abs(restored.lat - boat.lat) <= 0.5e-7 + 1e-12);
+        assert(std::abs(restored.lng - boat.lng) <= 0.5e-7 + 1e-12);
+        double heading_error = std::abs(restored.heading - std::fmod(boat.heading + 360.0, 360.0));
+        assert(std::min(heading_error, 360.0 - heading_error) <= 0.005 + 1e-9);
+        assert(std::abs(restored.speed - boat.speed) <= 0.005 + 1e-9);
+        assert(restored.status == boat.status);
+        assert(restored.route_direction == boat.route_direction);
+    }
+    assert(PackedBoatState::pack(boats[0]).heading_cdeg == 0);
+    assert(PackedBoatState::pack(boats[1]).getHeading() == 270.0);
+    
+    // 打包后按ID升序，重复ID保留最后一条
+    std::vector<BoatState> duplicated = {boats[5], boats[3], boats[5]};
+    duplicated.back().speed = 3.0;
+    auto packed = packBoatStates(duplicated);
+    assert(packed.size() == 2);
+    assert(packed[0].sysid == boats[3].sysid && packed[1].sysid == boats[5].sysid);
+    assert(packed[1].getSpeed() == 3.0);
+    assert(findPackedBoat(packed, boats[5].sysid) == &packed[1]);
+    assert(findPackedBoat(packed, 0) == nullptr);
+    
+    // 状态发布时整表复制：紧凑记录数组对比按ID排序的状态表
+    std::map<int, BoatState> table;
+    for (const auto& boat : boats) table[boat.sysid] = boat;
+    auto fleet = packBoatStates(boats);
+    const int copies = 50;
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < copies; ++k) {
+        std::map<int, BoatState> copy(table);
+        checksum += copy.size();
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int k = 0; k < copies; ++k) {
+        std::vector<PackedBoatState> copy(fleet);
+        checksum += copy.size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "10000船状态表复制: 状态表 "
+              << std::chrono::duration<double, std::micro>(middle - start).count() / copies
+              << " 微秒, 紧凑记录 "
+              << std::chrono::duration<double, std::micro>(end - middle).count() / copies
+              << " 微秒 (记录 " << sizeof(PackedBoatState) << " 字节)" << std::endl;
+    assert(checksum == 2 * copies * boats.size());
+    
+    std::cout << "紧凑船只记录测试通过!" << std::endl;
+}
+
+void testBroadPhaseMatchesBruteForce() {
+    std::cout << "测试空间网格粗筛与暴力遍历一致性..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    auto boats = createRandomFleet(400, 42);
+    
+    CollisionDetector grid_detector(config);
+    grid_detector.updateBoatStates(boats);
+    
+    CollisionDetector brute_detector(config);
+    brute_detector.setBroadPhaseEnabled(false);
+    brute_detector.updateBoatStates(boats);
+    
+    auto grid_alerts = grid_detector.detectCollisions();
+    auto brute_alerts = brute_detector.detectCollisions();
+    std::cout << "网格告警数: " << grid_alerts.size()
+              << ", 暴力遍历告警数: " << brute_alerts.size() << std::endl;
+    
+    assert(!brute_alerts.empty());
+    assertSameAlerts(grid_alerts, brute_alerts);
+    
+    // 暴力遍历枚举全部船对，其中远距离船对由运动学距离界剪枝
+    const DetectionStats& stats = brute_detector.getLastStats();
+    assert(stats.candidate_pairs == boats.size() * (boats.size() - 1) / 2);
+    assert(stats.pruned_pairs > 0);
+    assert(stats.pruned_pairs + stats.solved_pairs == stats.candidate_pairs);
+    std::cout << "候选船对: " << stats.candidate_pairs
+              << ", 剪枝船对: " << stats.pruned_pairs << std::endl;
+    
+    std::cout << "空间网格粗筛测试通过!" << std::endl;
+}
+
+void testFusedPassMatchesReference() {
+    std::cout << "测试融合遍历与逐类型遍历一致性..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    for (unsigned int seed : {1u, 7u, 2024u}) {
+        auto boats = createRandomFleet(300, seed);
+        
+        CollisionDetector detector(config);
+        detector.updateBoatStates(boats);
+        auto alerts = detector.detectCollisions();
+        auto expected = referenceDetect(boats, config);
+        assert(!expected.empty());
+        
+        assertSameAlerts(alerts, expected);
+    }
+    
+    std::cout << "融合遍历测试通过!" << std::endl;
+}
+
+void testVectorizedCollisionKernel() {
+    std::cout << "测试向量化碰撞时间内核..." << std::endl;
+    std::cout << "当前CPU指令集: "
+              << geometry::simdBackendName(geometry::detectSimdBackend()) << std::endl;
+    
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<double> pos_dist(-300.0, 300.0);
+    std::uniform_real_distribution<double> vel_dist(-4.0, 4.0);
+    
+    // 长度不是向量宽度整数倍，覆盖尾部标量处理
+    const size_t count = 1003;
+    std::vector<double> xs(count), ys(count), vxs(count), vys(count);
+    for (size_t k = 0; k < count; ++k) {
+        xs[k] = pos_dist(rng);
+        ys[k] = pos_dist(rng);
+        vxs[k] = vel_dist(rng);
+        vys[k] = vel_dist(rng);
+    }
+    // 边界情况：相对静止、已处于碰撞半径内、正对驶来
+    xs[0] = 10.0; ys[0] = 5.0; vxs[0] = 1.0; vys[0] = -2.0;
+    xs[1] = 0.5;  ys[1] = 0.3;
+    xs[2] = 100.0; ys[2] = 0.0; vxs[2] = -3.0; vys[2] = -2.0;
+    
+    const double x0 = 0.0, y0 = 0.0, vx0 = 1.0, vy0 = -2.0, radius = 1.5;
+    
+    std::vector<double> expected(count);
+    for (size_t k = 0; k < count; ++k) {
+        expected[k] = geometry::calculateCollisionTime(
+            xs[k] - x0, ys[k] - y0, vxs[k] - vx0, vys[k] - vy0, radius);
+    }
+    assert(expected[0] == -1);
+    assert(expected[1] > 0);
+    assert(expected[2] > 0);
+    
+    for (auto backend : {geometry::SimdBackend::SCALAR, geometry::SimdBackend::NEON,
+                         geometry::SimdBackend::AVX2, geometry::SimdBackend::AVX512}) {
+        std::vector<double> times(count, 0.0);
+        geometry::calculateCollisionTimes(backend, x0, y0, vx0, vy0,
+                                          xs.data(), ys.data(), vxs.data(), vys.data(),
+                                          count, radius, times.data());
+        for (size_t k = 0; k < count; ++k) {
+            double tolerance = 1e-12 * std::max(1.0, std::abs(expected[k]));
+            assert(std::abs(times[k] - expected[k]) <= tolerance);
+        }
+    }
+    
+    std::cout << "向量化碰撞时间内核测试通过!" << std::endl;
+}
+
+void testIncrementalDetection() {
+    std::cout << "测试增量检测..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    auto boats = createRandomFleet(300, 99);
+    
+    // 切平面投影的坐标差与原点有关(二阶项)，对照检测器使用相同原点
+    const GeoPoint origin = boats.front().getPosition();
+    CollisionDetector incremental(config);
+    incremental.setIncrementalEnabled(true, 10);
+    incremental.setProjectionOrigin(origin);
+    incremental.updateBoatStates(boats);
+    incremental.detectCollisions();
+    assert(incremental.getLastStats().full_revalidation);
+    
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<size_t> pick(0, boats.size() - 1);
+    size_t solved = 0, candidates = 0;
+    
+    for (int tick = 0; tick < 25; ++tick) {
+        // 每次只有约10%的船只上报新位置
+        for (int k = 0; k < 30; ++k) {
+            BoatState& boat = boats[pick(rng)];
+            boat.lat += 1e-6 * std::cos(geometry::toRadians(boat.heading)) * boat.speed;
+            boat.lng += 1e-6 * std::sin(geometry::toRadians(boat.heading)) * boat.speed;
+            incremental.updateBoatState(boat);
+        }
+        
+        auto alerts = incremental.detectCollisions();
+        const DetectionStats& stats = incremental.getLastStats();
+        if (!stats.full_revalidation) {
+            solved += stats.solved_pairs;
+            candidates += stats.candidate_pairs;
+        }
+        
+        CollisionDetector full(config);
+        full.setProjectionOrigin(origin);
+        full.updateBoatStates(boats);
+        assertSameAlerts(alerts, full.detectCollisions());
+    }
+    
+    std::cout << "增量检测求解船对: " << solved << " / 候选船对: " << candidates << std::endl;
+    assert(solved < candidates / 2);
+    
+    std::cout << "增量检测测试通过!" << std::endl;
+}
+
+// 当前进程的线程数(读取/proc，不支持时返回0)
+size_t countProcessThreads() {
+    std::error_code error;
+    std::filesystem::directory_iterator it("/proc/self/task", error);
+    if (error) return 0;
+    return static_cast<size_t>(std::distance(it, std::filesystem::directory_iterator()));
+}
+
+void testParallelDetection() {
+    std::cout << "测试多线程检测..." << std::endl;
+    
+    // 线程池：每个任务恰好执行一次
+    WorkStealingThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    for (int round = 0; round < 3; ++round) {
+        pool.parallelFor(hits.size(), [&](size_t task, size_t worker) {
+            assert(worker < pool.getWorkerCount());
+            hits[task].fetch_add(1);
+        });
+    }
+    for (const auto& hit : hits) {
+        assert(hit.load() == 3);
+    }
+    
+    SystemConfig config = SystemConfig::getDefault();
+    auto boats = createRandomFleet(800, 31);
+    
+    // 工作线程在第一次并行检测时才启动：多个只做小船队检测的检测器不占用线程
+    size_t threads_before = countProcessThreads();
+    SystemConfig pooled_config = config;
+    pooled_config.detection_threads = 4;
+    std::vector<std::unique_ptr<CollisionDetector>> idle;
+    for (int k = 0; k < 8; ++k) {
+        idle.push_back(std::make_unique<CollisionDetector>(pooled_config));
+        idle.back()->updateBoatStates(createRandomFleet(50, 40 + k));
+        idle.back()->detectCollisions();
+    }
+    assert(countProcessThreads() == threads_before);
+    idle.front()->updateBoatStates(boats);
+    idle.front()->detectCollisions();
+    // 调用线程作为0号工作者参与执行，另启动3个工作线程
+    if (threads_before > 0) assert(countProcessThreads() == threads_before + 3);
+    idle.clear();
+    
+    CollisionDetector serial(config);
+    serial.setThreadCount(1);
+    serial.updateBoatStates(boats);
+    auto expected = serial.detectCollisions();
+    assert(!expected.empty());
+    
+    // 多线程结果必须与单线程逐位一致
+    for (int threads : {2, 4, 7}) {
+        CollisionDetector parallel(config);
+        parallel.setThreadCount(threads);
+        assert(parallel.getThreadCount() == static_cast<size_t>(threads));
+        parallel.updateBoatStates(boats);
+        assertSameAlerts(parallel.detectCollisions(), expected, 0.0);
+        assert(parallel.getLastStats().candidate_pairs == serial.getLastStats().candidate_pairs);
+        assert(parallel.getLastStats().solved_pairs == serial.getLastStats().solved_pairs);
+    }
+    
+    // 多线程与增量模式组合
+    CollisionDetector parallel(config);
+    parallel.setThreadCount(4);
+    parallel.setIncrementalEnabled(true, 5);
+    parallel.updateBoatStates(boats);
+    parallel.detectCollisions();
+    for (int tick = 0; tick < 8; ++tick) {
+        for (size_t k = static_cast<size_t>(tick); k < boats.size(); k += 13) {
+            boats[k].lat += 1e-6 * boats[k].speed;
+            parallel.updateBoatState(boats[k]);
+        }
+        serial.updateBoatStates(boats);
+        assertSameAlerts(parallel.detectCollisions(), serial.detectCollisions(), 0.0);
+    }
+    
+    std::cout << "多线程检测测试通过!" << std::endl;
+}
+
+void testKineticDetection() {
+    std::cout << "测试动态证书检测..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    auto boats = createRandomFleet(300, 17);
+    double start = boats.front().timestamp;
+    
+    // 检测时刻等于上报时刻时与周期检测一致
+    CollisionDetector kinetic(config);
+    kinetic.updateBoatStates(boats);
+    CollisionDetector periodic(config);
+    periodic.updateBoatStates(boats);
+    assertSameAlerts(kinetic.detectCollisionsAt(start), periodic.detectCollisions());
+    
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<size_t> pick(1, boats.size() - 1);
+    std::uniform_real_distribution<double> turn(-30.0, 30.0);
+    size_t steady_ticks = 0, events = 0, solved = 0;
+    
+    // 第10秒有一批船只离港(停止上报)，第14秒以原状态重新加入
+    const size_t churn_begin = 200, churn_end = 220;
+    std::vector<BoatState> departed(boats.begin() + churn_begin, boats.begin() + churn_end);
+    
+    for (int tick = 1; tick <= 40; ++tick) {
+        double now = start + tick;
+        
+        if (tick == 10) {
+            boats.erase(boats.begin() + churn_begin, boats.begin() + churn_end);
+            kinetic.updateBoatStates(boats);
+        } else if (tick == 14) {
+            boats.insert(boats.begin() + churn_begin, departed.begin(), departed.end());
+            kinetic.updateBoatStates(boats);
+            pick = std::uniform_int_distribution<size_t>(1, boats.size() - 1);
+        }
+        
+        // 每隔几秒有少量船只按外推位置上报新的航向
+        if (tick % 4 == 0) {
+            for (int k = 0; k < 5; ++k) {
+                BoatState& boat = boats[pick(rng)];
+                double elapsed = now - boat.timestamp;
+                double heading_rad = geometry::toRadians(boat.heading);
+                double meters_per_deg_lat = geometry::EARTH_RADIUS * M_PI / 180.0;
+                boat.lat += boat.speed * std::cos(heading_rad) * elapsed / meters_per_deg_lat;
+                boat.lng += boat.speed * std::sin(heading_rad) * elapsed /
+                            (meters_per_deg_lat * std::cos(geometry::toRadians(boats.front().lat)));
+                boat.heading = std::fmod(boat.heading + turn(rng) + 360.0, 360.0);
+                boat.timestamp = now;
+                kinetic.updateBoatState(boat);
+            }
+        }
+        
+        auto alerts = kinetic.detectCollisionsAt(now);
+        const DetectionStats& stats = kinetic.getLastStats();
+        events += stats.kinetic_events;
+        solved += stats.solved_pairs;
+        if (tick % 4 != 0 && tick != 10 && !stats.full_revalidation) {
+            // 无新状态且网格未到期时只处理到期证书，不求解任何船对
+            assert(stats.solved_pairs == 0);
+            ++steady_ticks;
+        }
+        
+        // 每一步都与无状态的逐对参考实现(按上报时间戳外推到当前时刻)比较，
+        // 同时与新建检测器比较，确认增量维护的证书与从头求解一致
+        assertSameAlerts(alerts, referenceDetect(boats, config, true, now));
+        CollisionDetector fresh(config);
+        fresh.updateBoatStates(boats);
+        assertSameAlerts(alerts, fresh.detectCollisionsAt(now));
+    }
+    std::cout << "动态检测处理事件: " << events << " / 求解船对: " << solved << std::endl;
+    assert(steady_ticks > 0 && events > 0);
+    
+    // 离开的船只不保留版本记录
+    CollisionDetector shrinking(config);
+    shrinking.updateBoatStates(boats);
+    shrinking.detectCollisionsAt(start + 41);
+    shrinking.updateBoatStates(std::vector<BoatState>(boats.begin(), boats.begin() + 50));
+    assert(shrinking.getTrackedVersionCount() == 50);
+    
+    std::cout << "动态证书检测测试通过!" << std::endl;
+}
+
+std::vector<CollisionAlert> alertsForBoat(const std::vector<CollisionAlert>& alerts, int boat_id) {
+    std::vector<CollisionAlert> result;
+    for (const auto& alert : alerts) {
+        if (alert.current_boat_id == boat_id) result.push_back(alert);
+    }
+    return result;
+}
+
+void testEvaluateBoat() {
+    std::cout << "测试单船准入查询..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    auto boats = createRandomFleet(2000, 77);
+    
+    CollisionDetector detector(config);
+    detector.updateBoatStates(boats);
+    auto full = detector.detectCollisions();
+    
+    // 按当前状态查询与全量检测中该船的告警一致
+    for (int boat_id = 1; boat_id <= 2000; boat_id += 37) {
+        assertSameAlerts(detector.evaluateBoat(boat_id), alertsForBoat(full, boat_id), 0.0);
+    }
+    
+    // 假设某船以更高航速开始出坞
+    BoatState undocking = boats[100];
+    undocking.status = BoatStatus::UNDOCKING;
+    undocking.speed = 6.0;
+    undocking.heading = 45.0;
+    auto hypothetical = detector.evaluateBoat(undocking.sysid, undocking);
+    
+    auto modified = boats;
+    modified[100] = undocking;
+    CollisionDetector reference(config);
+    reference.updateBoatStates(modified);
+    assertSameAlerts(hypothetical, alertsForBoat(reference.detectCollisions(), undocking.sysid));
+    
+    // 尚未加入船队的船只
+    BoatState newcomer = boats[5];
+    newcomer.sysid = 5000;
+    newcomer.status = BoatStatus::UNDOCKING;
+    auto joined = boats;
+    joined.push_back(newcomer);
+    reference.updateBoatStates(joined);
+    assertSameAlerts(detector.evaluateBoat(5000, newcomer),
+                     alertsForBoat(reference.detectCollisions(), 5000));
+    
+    // 查询不改变检测器状态
+    assertSameAlerts(detector.detectCollisions(), full, 0.0);
+    
+    auto start = std::chrono::steady_clock::now();
+    const int queries = 200;
+    for (int k = 0; k < queries; ++k) {
+        detector.evaluateBoat(1 + (k * 13) % 2000, undocking);
+    }
+    double elapsed_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "2000船单船查询平均耗时: " << elapsed_us / queries << " 微秒" << std::endl;
+    
+    std::cout << "单船准入查询测试通过!" << std::endl;
+}
+
+// 以(lat0, lng0)为原点的局部平面坐标(米)转换为经纬度
+GeoPoint localToGeo(double x, double y) {
+    const double lat0 = 30.5490;
+    const double lng0 = 114.3420;
+    double meters_per_deg_lat = geometry::EARTH_RADIUS * M_PI / 180.0;
+    return GeoPoint(lat0 + y / meters_per_deg_lat,
+                    lng0 + x / (meters_per_deg_lat * std::cos(geometry::toRadians(lat0))));
+}
+
+BoatState createRouteBoat(int sysid, double x, double y, double heading, double speed) {
+    BoatState boat;
+    boat.sysid = sysid;
+    GeoPoint pos = localToGeo(x, y);
+    boat.lat = pos.lat;
+    boat.lng = pos.lng;
+    boat.heading = heading;
+    boat.speed = speed;
+    boat.status = BoatStatus::NORMAL_SAIL;
+    boat.route_direction = RouteDirection::CLOCKWISE;
+    boat.timestamp = 1722325256.530;
+    return boat;
+}
+
+void testRouteArcLengthIndex() {
+    std::cout << "测试航线弧长索引..." << std::endl;
+    
+    // 折返航线：沿y=0向东100米，北移1米后沿y=1向西返回
+    RouteInfo route;
+    route.route_id = 1;
+    route.direction = RouteDirection::CLOCKWISE;
+    route.points = {localToGeo(0, 0), localToGeo(100, 0), localToGeo(100, 1), localToGeo(0, 1)};
+    
+    // 1号船在去程，3号船在回程且与1号船相向；2号船在去程更远处
+    std::vector<BoatState> boats = {
+        createRouteBoat(1, 20, 0, 90.0, 2.0),
+        createRouteBoat(2, 60, 0, 90.0, 0.5),
+        createRouteBoat(3, 50, 1, 270.0, 2.0),
+    };
+    
+    BoatSnapshot snapshot;
+    std::map<int, BoatState> states;
+    for (const auto& boat : boats) states[boat.sysid] = boat;
+    snapshot.build(states, boats.front().getPosition());
+    
+    RouteIndex index;
+    index.setRoutes({route});
+    index.build(snapshot, 10.0);
+    
+    // 回程与去程重叠时按航向选择同向航段
+    assert(index.isMatched(0) && index.isMatched(1) && index.isMatched(2));
+    assert(std::abs(index.getArcLength(0) - 20.0) < 0.01);
+    assert(std::abs(index.getArcLength(1) - 60.0) < 0.01);
+    assert(std::abs(index.getArcLength(2) - 151.0) < 0.01);
+    assert(index.nearestAhead(0) == 1);
+    assert(index.nearestAhead(1) == 2);
+    assert(index.nearestAhead(2) == RouteIndex::kNoBoat);
+    assert(index.nearestAheadOf(1, 30.0) == 1);
+    assert(index.nearestAheadOf(1, 200.0) == RouteIndex::kNoBoat);
+    
+    // 去掉2号船后，1号船与3号船相向驶近：
+    // 按航向45度判断双方都认为对方在前方，按航线弧长只有1号船的前船是3号船
+    boats.erase(boats.begin() + 1);
+    SystemConfig config = SystemConfig::getDefault();
+    
+    CollisionDetector cone_detector(config);
+    cone_detector.updateBoatStates(boats);
+    auto cone_alerts = cone_detector.detectCollisions();
+    assert(cone_alerts.size() == 2);
+    
+    CollisionDetector route_detector(config);
+    route_detector.setRouteInfo({route});
+    route_detector.updateBoatStates(boats);
+    auto route_alerts = route_detector.detectCollisions();
+    assert(route_alerts.size() == 1);
+    assert(route_alerts[0].current_boat_id == 1);
+    assert(route_alerts[0].front_boat_ids == std::vector<int>{3});
+    
+    std::cout << "航线弧长索引测试通过!" << std::endl;
+}
+
+void testRouteGeometry() {
+    std::cout << "测试航线几何表..." << std::endl;
+
+    // 蛇形航线：4000个航段在约2公里见方的水域内往返，相邻航段方向变化
+    GeoPoint origin(30.5490, 114.3420);
+    geometry::LocalProjector projector(origin);
+    std::mt19937 rng(24);
+    std::uniform_real_distribution<double> jitter(-3.0, 3.0);
+    std::vector<GeoPoint> points;
+    std::vector<double> xs, ys;
+    for (int k = 0; k <= 4000; ++k) {
+        int row = k / 100;
+        int col = (row % 2 == 0) ? k % 100 : 99 - k % 100;
+        double x = col * 20.0 + jitter(rng);
+        double y = row * 50.0 + jitter(rng);
+        points.push_back(projector.unproject(x, y));
+        projector.project(points.back().lat, points.back().lng, x, y);
+        xs.push_back(x);
+        ys.push_back(y);
+    }
+    // 零长度航段
+    points.push_back(points.back());
+    xs.push_back(xs.back());
+    ys.push_back(ys.back());
+
+    RouteGeometry route;
+    route.build(points, projector);
+    assert(route.segmentCount() == points.size() - 1);
+
+    // 逐航段计算的参照结果
+    auto bruteForce = [&](double px, double py, double hx, double hy, double max_offset,
+                          double& nearest_offset, double& nearest_arc,
+                          bool& located, double& located_arc) {
+        nearest_offset = std::numeric_limits<double>::infinity();
+        located = false;
+        bool best_aligned = false;
+        double best_offset = std::numeric_limits<double>::infinity();
+        double arc = 0.0;
+        for (size_t k = 0; k + 1 < xs.size(); ++k) {
+            double sx = xs[k + 1] - xs[k], sy = ys[k + 1] - ys[k];
+            double length = std::hypot(sx, sy);
+            double u = length > 0 ? ((px - xs[k]) * sx + (py - ys[k]) * sy) / (length * length) : 0.0;
+            u = std::max(0.0, std::min(1.0, u));
+            double offset = std::hypot(px - xs[k] - u * sx, py - ys[k] - u * sy);
+            if (offset < nearest_offset) {
+                nearest_offset = offset;
+                nearest_arc = arc + u * length;
+            }
+            bool aligned = hx * sx + hy * sy >= 0;
+            if (offset <= max_offset &&
+                ((aligned && !best_aligned) || (aligned == best_aligned && offset < best_offset))) {
+                best_aligned = aligned;
+                best_offset = offset;
+                located = true;
+                located_arc = arc + u * length;
+            }
+            arc += length;
+        }
+    };
+
+    std::uniform_real_distribution<double> px(-100.0, 2100.0), py(-100.0, 2100.0), angle(0.0, 2 * M_PI);
+    const int queries = 2000;
+    std::vector<double> qx(queries), qy(queries), qhx(queries), qhy(queries);
+    for (int q = 0; q < queries; ++q) {
+        qx[q] = px(rng);
+        qy[q] = py(rng);
+        double heading = angle(rng);
+        qhx[q] = std::sin(heading);
+        qhy[q] = std::cos(heading);
+    }
+
+    double brute_ms = 0.0;
+    size_t located_count = 0;
+    for (int q = 0; q < queries; ++q) {
+        double nearest_offset, nearest_arc, located_arc = 0.0;
+        bool located;
+        auto start = std::chrono::steady_clock::now();
+        bruteForce(qx[q], qy[q], qhx[q], qhy[q], 10.0, nearest_offset, nearest_arc, located, located_arc);
+        brute_ms += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        RouteGeometry::Projection projection;
+        assert(route.nearest(qx[q], qy[q], projection));
+        assert(std::abs(projection.offset - nearest_offset) < 1e-6);
+        assert(std::abs(route.distanceTo(qx[q], qy[q]) - nearest_offset) < 1e-6);
+
+        RouteGeometry::Projection best;
+        best.aligned = false;
+        best.offset = std::numeric_limits<double>::infinity();
+        assert(route.locate(qx[q], qy[q], qhx[q], qhy[q], 10.0, best) == located);
+        if (located) {
+            assert(std::abs(best.arc - located_arc) < 1e-6);
+            ++located_count;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    double checksum = 0.0;
+    for (int q = 0; q < queries; ++q) checksum += route.distanceTo(qx[q], qy[q]);
+    double tree_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << route.segmentCount() << " 个航段, 命中航线 " << located_count << "/" << queries
+              << ", 逐航段计算耗时: " << brute_ms << " 毫秒, 几何表查询耗时: " << tree_ms
+              << " 毫秒(校验和 " << checksum << ")" << std::endl;
+    assert(located_count > 0);
+
+    // 航线终点越过后投影到终点，弧长为全长；空航线没有投影
+    RouteGeometry::Projection end;
+    assert(route.nearest(xs.back() + 5.0, ys.back(), end));
+    assert(std::abs(end.arc - route.totalLength()) < 1e-6);
+    RouteGeometry empty_route;
+    empty_route.build({origin}, projector);
+    assert(empty_route.empty() && !empty_route.nearest(0.0, 0.0, end));
+
+    // 与球面点到线段距离一致(短航段上平面近似成立)
+    RouteGeometry segment;
+    GeoPoint a = projector.unproject(0.0, 0.0), b = projector.unproject(200.0, 0.0);
+    segment.build({a, b}, projector);
+    GeoPoint p = projector.unproject(80.0, 30.0);
+    assert(std::abs(segment.distanceTo(80.0, 30.0) - geometry::pointToLineDistance(p, a, b)) < 0.05);
+
+    std::cout << "航线几何表测试通过!" << std::endl;
+}
+
+void testHarborRTree() {
+    std::cout << "测试港区R树..." << std::endl;
+
+    // 约3公里见方的港区：2000个船坞
+    std::mt19937 rng(25);
+    std::uniform_real_distribution<double> coord(0.0, 3000.0);
+    std::vector<DockInfo> docks;
+    for (int d = 0; d < 2000; ++d) {
+        GeoPoint position = localToGeo(coord(rng), coord(rng));
+        docks.push_back({d + 1, position.lat, position.lng});
+    }
+
+    HarborRTree tree;
+    tree.build(docks);
+    assert(tree.size() == docks.size());
+    const geometry::LocalProjector& projector = tree.getProjector();
+
+    // 逐个计算的参照结果
+    std::vector<std::pair<double, double>> positions;
+    for (const auto& dock : docks) {
+        double x, y;
+        projector.project(dock.lat, dock.lng, x, y);
+        positions.emplace_back(x, y);
+    }
+    auto bruteForce = [&](double px, double py) {
+        std::vector<std::pair<double, size_t>> hits;
+        for (size_t d = 0; d < positions.size(); ++d) {
+            double dx = positions[d].first - px, dy = positions[d].second - py;
+            hits.emplace_back(std::sqrt(dx * dx + dy * dy), d);
+        }
+        std::sort(hits.begin(), hits.end());
+        return hits;
+    };
+
+    std::uniform_real_distribution<double> query(-500.0, 3500.0);
+    std::vector<HarborRTree::Hit> hits;
+    size_t radius_hits = 0;
+    for (int q = 0; q < 500; ++q) {
+        double px = query(rng), py = query(rng);
+        auto expected = bruteForce(px, py);
+
+        tree.nearest(px, py, 5, hits);
+        assert(hits.size() == 5);
+        for (size_t k = 0; k < hits.size(); ++k) {
+            assert(hits[k].item == expected[k].second);
+            assert(std::abs(hits[k].distance - expected[k].first) < 1e-9);
+        }
+
+        tree.withinRadius(px, py, 150.0, hits);
+        size_t inside = std::count_if(expected.begin(), expected.end(),
+                                      [](const std::pair<double, size_t>& hit) {
+                                          return hit.first <= 150.0;
+                                      });
+        assert(hits.size() == inside);
+        for (size_t k = 0; k < hits.size(); ++k) {
+            assert(hits[k].item == expected[k].second);
+        }
+        radius_hits += hits.size();
+    }
+
+    // 经纬度查询与投影坐标查询一致；k超过船坞数时返回全部船坞
+    GeoPoint point = localToGeo(1200.0, 800.0);
+    double px, py;
+    projector.project(point.lat, point.lng, px, py);
+    std::vector<HarborRTree::Hit> projected;
+    tree.nearest(point, 3, hits);
+    tree.nearest(px, py, 3, projected);
+    assert(hits.size() == 3 && hits[0].item == projected[0].item);
+    tree.nearest(point, 10000, hits);
+    assert(hits.size() == docks.size());
+
+    // 重建后不含已移除的船坞
+    tree.build({});
+    tree.nearest(point, 1, hits);
+    assert(hits.empty());
+
+    auto start = std::chrono::steady_clock::now();
+    tree.build(docks);
+    double build_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << tree.size() << " 个船坞, 建树耗时: " << build_ms
+              << " 毫秒, 半径查询命中: " << radius_hits << std::endl;
+
+    std::cout << "港区R树测试通过!" << std::endl;
+}
+
+void testAlertDeltas() {
+    std::cout << "测试告警变化流..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    config.alert_hysteresis_s = 1.0;
+    const double radius = config.boat.length * 2.0;
+    
+    // 出坞船以1米/秒驶向静止船只，碰撞时间约为 间距 - 安全距离
+    CollisionDetector detector(config);
+    BoatState undocking = createRouteBoat(1, 0.0, 0.0, 90.0, 1.0);
+    undocking.status = BoatStatus::UNDOCKING;
+    auto placeAt = [&](double collision_time) {
+        BoatState stopped = createRouteBoat(2, radius + collision_time, 0.0, 90.0, 0.0);
+        detector.updateBoatStates(std::vector<BoatState>{undocking, stopped});
+        return detector.detectAlertChanges();
+    };
+    
+    assert(placeAt(100.0).empty());
+    assert(detector.getCurrentAlerts().empty());
+    
+    auto deltas = placeAt(20.0);
+    assert(deltas.size() == 1);
+    assert(deltas[0].event == AlertEvent::NEW);
+    assert(deltas[0].alert.level == AlertLevel::WARNING);
+    assert(deltas[0].alert.type == AlertType::UNDOCKING);
+    assert(deltas[0].alert.current_boat_id == 1);
+    uint64_t alert_id = deltas[0].alert.alert_id;
+    assert(alert_id != 0);
+    
+    // 等级不变时只更新告警表，不产生事件
+    assert(placeAt(18.0).empty());
+    assert(detector.getCurrentAlerts().size() == 1);
+    assert(detector.getCurrentAlerts()[0].alert_id == alert_id);
+    assert(std::abs(detector.getCurrentAlerts()[0].collision_time - 18.0) < 0.1);
+    
+    deltas = placeAt(3.0);
+    assert(deltas.size() == 1);
+    assert(deltas[0].event == AlertEvent::ESCALATED);
+    assert(deltas[0].previous_level == AlertLevel::WARNING);
+    assert(deltas[0].alert.level == AlertLevel::EMERGENCY);
+    assert(deltas[0].alert.alert_id == alert_id);
+    
+    // 碰撞时间在阈值附近波动时保持原等级
+    for (double t : {5.5, 4.8, 5.6, 5.2}) {
+        assert(placeAt(t).empty());
+        assert(detector.getCurrentAlerts()[0].level == AlertLevel::EMERGENCY);
+    }
+    
+    deltas = placeAt(6.5);
+    assert(deltas.size() == 1);
+    assert(deltas[0].event == AlertEvent::DEESCALATED);
+    assert(deltas[0].previous_level == AlertLevel::EMERGENCY);
+    assert(deltas[0].alert.level == AlertLevel::WARNING);
+    assert(deltas[0].alert.alert_id == alert_id);
+    
+    for (double t : {30.5, 29.5, 30.8}) {
+        assert(placeAt(t).empty());
+        assert(detector.getCurrentAlerts().size() == 1);
+    }
+    
+    // 无状态检测不受滞回影响
+    assert(detector.detectCollisions().empty());
+    
+    deltas = placeAt(31.5);
+    assert(deltas.size() == 1);
+    assert(deltas[0].event == AlertEvent::CLEARED);
+    assert(deltas[0].previous_level == AlertLevel::WARNING);
+    assert(deltas[0].alert.level == AlertLevel::NORMAL);
+    assert(deltas[0].alert.alert_id == alert_id);
+    assert(detector.getCurrentAlerts().empty());
+    
+    // 解除后再次告警使用新ID
+    deltas = placeAt(10.0);
+    assert(deltas.size() == 1);
+    assert(deltas[0].event == AlertEvent::NEW);
+    assert(deltas[0].alert.alert_id > alert_id);
+    
+    // 船只离开船队时告警解除
+    detector.updateBoatStates(std::vector<BoatState>{undocking});
+    deltas = detector.detectAlertChanges();
+    assert(deltas.size() == 1);
+    assert(deltas[0].event == AlertEvent::CLEARED);
+    
+    // 稳定船队的重复检测不产生事件，告警表与无状态检测一致
+    auto boats = createRandomFleet(300, 13);
+    detector.updateBoatStates(boats);
+    auto first = detector.detectAlertChanges();
+    assert(detector.detectAlertChanges().empty());
+    assertSameAlerts(detector.getCurrentAlerts(), detector.detectCollisions(), 0.0);
+    size_t new_alerts = 0;
+    for (const auto& delta : first) {
+        if (delta.event == AlertEvent::NEW) ++new_alerts;
+    }
+    assert(new_alerts == detector.getCurrentAlerts().size());
+    
+    std::cout << "告警变化流测试通过!" << std::endl;
+}
+
+void testAllocationFreeDetection() {
+    std::cout << "测试检测热路径堆分配..." << std::endl;
+    
+    // 多条相距50米的跟随航道，航道内快慢船交替，每船最多一条前船告警
+    std::vector<BoatState> base;
+    int sysid = 1;
+    for (int lane = 0; lane < 20; ++lane) {
+        for (int k = 0; k < 25; ++k) {
+            BoatState boat = createRouteBoat(sysid++, k * 12.0, lane * 50.0, 90.0,
+                                             k % 2 == 0 ? 2.0 : 1.0);
+            if (lane % 5 == 0 && k == 0) boat.status = BoatStatus::UNDOCKING;
+            base.push_back(boat);
+        }
+    }
+    
+    // 奇偶轮次整体平移，船只状态每轮都变化而相对几何关系不变
+    double shift_lng = localToGeo(0.5, 0.0).lng - localToGeo(0.0, 0.0).lng;
+    auto shifted = base;
+    for (auto& boat : shifted) {
+        boat.lng += shift_lng;
+    }
+    
+    for (bool incremental : {false, true}) {
+        SystemConfig config = SystemConfig::getDefault();
+        config.detection_threads = 1;
+        CollisionDetector detector(config);
+        detector.setIncrementalEnabled(incremental, 4);
+        
+        size_t allocations = 0;
+        size_t alert_count = 0;
+        for (int tick = 0; tick < 24; ++tick) {
+            detector.updateBoatStates(tick % 2 == 0 ? base : shifted);
+            
+            size_t before = g_allocation_count.load();
+            const auto& alerts = detector.detectCollisionsInPlace();
+            size_t after = g_allocation_count.load();
+            
+            // 前几轮为预热，之后不应再分配
+            if (tick >= 4) allocations += after - before;
+            alert_count = alerts.size();
+            for (const auto& alert : alerts) {
+                assert(alert.front_boat_ids.size() <= BoatIdList::kInlineCapacity);
+                assert(!alert.decision_advice.empty());
+            }
+        }
+        std::cout << (incremental ? "增量" : "全量") << "检测稳定状态堆分配次数: " << allocations
+                  << ", 告警数: " << alert_count << std::endl;
+        assert(alert_count > 0);
+        assert(allocations == 0);
+        
+        // 告警表更新在没有告警变化时同样不分配
+        for (int tick = 0; tick < 4; ++tick) {
+            detector.updateBoatStates(tick % 2 == 0 ? base : shifted);
+            detector.detectAlertChanges();
+        }
+        size_t table_allocations = 0;
+        for (int tick = 0; tick < 10; ++tick) {
+            detector.updateBoatStates(tick % 2 == 0 ? base : shifted);
+            size_t before = g_allocation_count.load();
+            bool unchanged = detector.detectAlertChanges().empty();
+            table_allocations += g_allocation_count.load() - before;
+            assert(unchanged);
+        }
+        assert(table_allocations == 0);
+    }
+    
+    std::cout << "检测热路径堆分配测试通过!" << std::endl;
+}
+
+void testDockCorridorIndex() {
+    std::cout << "测试船坞通道索引..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    config.dock_corridor_radius_m = 20.0;
+    
+    std::vector<DockInfo> docks;
+    for (int d = 0; d < 2; ++d) {
+        DockInfo dock;
+        dock.dock_id = d + 1;
+        GeoPoint pos = localToGeo(d * 200.0, 0.0);
+        dock.lat = pos.lat;
+        dock.lng = pos.lng;
+        docks.push_back(dock);
+    }
+    
+    // 出坞船向北驶出1号船坞通道
+    BoatState undocking = createRouteBoat(1, 5.0, 0.0, 0.0, 1.0);
+    undocking.status = BoatStatus::UNDOCKING;
+    // 通道外横穿的船只，航迹不进入通道
+    BoatState crossing = createRouteBoat(3, 30.0, 25.0, 270.0, 1.0);
+    // 从北面驶入通道的船只
+    BoatState inbound = createRouteBoat(2, 5.0, 25.0, 180.0, 1.0);
+    
+    CollisionDetector open_water(config);
+    open_water.updateBoatStates(std::vector<BoatState>{undocking, crossing});
+    assert(alertsForBoat(open_water.detectCollisions(), 1).size() == 1);
+    
+    CollisionDetector detector(config);
+    detector.setDockInfo(docks);
+    detector.updateBoatStates(std::vector<BoatState>{undocking, crossing});
+    assert(alertsForBoat(detector.detectCollisions(), 1).empty());
+    assert(detector.evaluateBoat(1).empty());
+    
+    detector.updateBoatStates(std::vector<BoatState>{undocking, inbound});
+    auto alerts = alertsForBoat(detector.detectCollisions(), 1);
+    assert(alerts.size() == 1);
+    assert(alerts[0].oncoming_boat_ids == std::vector<int>{2} ||
+           alerts[0].front_boat_ids == std::vector<int>{2});
+    assertSameAlerts(detector.evaluateBoat(1), alerts, 0.0);
+    
+    // 换班时两个船坞同时有大量船只出坞，周围有正常航行船只
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<double> offset_dist(-15.0, 15.0);
+    std::uniform_real_distribution<double> area_dist(-100.0, 300.0);
+    std::uniform_real_distribution<double> heading_dist(0.0, 360.0);
+    std::uniform_real_distribution<double> speed_dist(0.5, 2.0);
+    std::vector<BoatState> fleet;
+    for (int id = 1; id <= 400; ++id) {
+        BoatState boat;
+        if (id <= 120) {
+            double dock_x = (id % 2) * 200.0;
+            boat = createRouteBoat(id, dock_x + offset_dist(rng), offset_dist(rng),
+                                   heading_dist(rng), speed_dist(rng));
+            boat.status = id % 7 == 0 ? BoatStatus::DOCKING : BoatStatus::UNDOCKING;
+        } else {
+            boat = createRouteBoat(id, area_dist(rng), area_dist(rng) - 100.0,
+                                   heading_dist(rng), speed_dist(rng));
+        }
+        fleet.push_back(boat);
+    }
+    
+    CollisionDetector harbor(config);
+    harbor.setDockInfo(docks);
+    harbor.updateBoatStates(fleet);
+    auto full = harbor.detectCollisions();
+    DetectionStats corridor_stats = harbor.getLastStats();
+    
+    CollisionDetector unrestricted(config);
+    unrestricted.updateBoatStates(fleet);
+    unrestricted.detectCollisions();
+    DetectionStats open_stats = unrestricted.getLastStats();
+    
+    std::cout << "通道排除船对: " << corridor_stats.corridor_pairs
+              << ", 求解船对: " << corridor_stats.solved_pairs << " / " << open_stats.solved_pairs << std::endl;
+    assert(corridor_stats.corridor_pairs > 0);
+    assert(corridor_stats.solved_pairs < open_stats.solved_pairs);
+    
+    // 单船查询只检查通道相关船只，结果与全量检测一致
+    for (int boat_id = 1; boat_id <= 400; boat_id += 3) {
+        assertSameAlerts(harbor.evaluateBoat(boat_id), alertsForBoat(full, boat_id), 0.0);
+    }
+    assertSameAlerts(harbor.detectCollisions(), full, 0.0);
+    
+    std::cout << "船坞通道索引测试通过!" << std::endl;
+}
+
+void testEvaluateBoatOnRoutes() {
+    std::cout << "测试航线上的单船准入查询..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    config.dock_corridor_radius_m = 20.0;
+    
+    // 4组折返航线：顺时针航线沿y=b向东400米后折返，沿y=b+20向西；
+    // 逆时针航线沿y=b+10向西。船坞位于各组航线西端
+    std::vector<RouteInfo> routes;
+    std::vector<DockInfo> docks;
+    for (int lane = 0; lane < 4; ++lane) {
+        double base = lane * 100.0;
+        RouteInfo hairpin;
+        hairpin.route_id = lane * 2 + 1;
+        hairpin.direction = RouteDirection::CLOCKWISE;
+        for (int k = 0; k <= 8; ++k) hairpin.points.push_back(localToGeo(k * 50.0, base));
+        for (int k = 8; k >= 0; --k) hairpin.points.push_back(localToGeo(k * 50.0, base + 20.0));
+        routes.push_back(hairpin);
+        
+        RouteInfo reverse;
+        reverse.route_id = lane * 2 + 2;
+        reverse.direction = RouteDirection::COUNTERCLOCKWISE;
+        for (int k = 8; k >= 0; --k) reverse.points.push_back(localToGeo(k * 50.0, base + 10.0));
+        routes.push_back(reverse);
+        
+        GeoPoint position = localToGeo(-15.0, base + 10.0);
+        docks.push_back({lane + 1, position.lat, position.lng});
+    }
+    
+    // 船只ID取偶数，新加入的奇数ID船只在快照中位于已有船只之间
+    std::mt19937 rng(512);
+    std::uniform_real_distribution<double> along(0.0, 400.0), jitter(-2.0, 2.0);
+    std::uniform_real_distribution<double> turn(-10.0, 10.0), speed(0.5, 3.0);
+    std::uniform_int_distribution<int> lane_pick(0, 3), kind_pick(0, 9);
+    auto createLaneBoat = [&](int sysid) {
+        double base = lane_pick(rng) * 100.0;
+        int kind = kind_pick(rng);
+        BoatState boat;
+        if (kind < 4) {
+            boat = createRouteBoat(sysid, along(rng), base + jitter(rng), 90.0 + turn(rng), speed(rng));
+        } else if (kind < 8) {
+            boat = createRouteBoat(sysid, along(rng), base + 20.0 + jitter(rng), 270.0 + turn(rng), speed(rng));
+        } else {
+            boat = createRouteBoat(sysid, along(rng), base + 10.0 + jitter(rng), 270.0 + turn(rng), speed(rng));
+            boat.route_direction = RouteDirection::COUNTERCLOCKWISE;
+        }
+        if (kind == 9 && sysid % 3 == 0) {
+            boat = createRouteBoat(sysid, -15.0 + jitter(rng), base + 10.0 + jitter(rng), 90.0, speed(rng));
+            boat.status = BoatStatus::UNDOCKING;
+        }
+        return boat;
+    };
+    std::vector<BoatState> fleet;
+    for (int k = 1; k <= 400; ++k) fleet.push_back(createLaneBoat(2 * k));
+    
+    auto configure = [&](CollisionDetector& detector) {
+        detector.setRouteInfo(routes);
+        detector.setDockInfo(docks);
+    };
+    CollisionDetector detector(config);
+    configure(detector);
+    detector.updateBoatStates(fleet);
+    auto full = detector.detectCollisions();
+    assert(!full.empty());
+    
+    // 按当前状态查询与全量检测中该船的告警一致
+    for (const auto& boat : fleet) {
+        assertSameAlerts(detector.evaluateBoat(boat.sysid), alertsForBoat(full, boat.sysid), 0.0);
+    }
+    
+    // 把船只移到折返航线的另一段或改为出坞：航线匹配、前船与通道都随假设状态变化
+    auto checkHypothetical = [&](const BoatState& hypothetical) {
+        auto modified = fleet;
+        auto it = std::lower_bound(modified.begin(), modified.end(), hypothetical.sysid,
+                                   [](const BoatState& b, int id) { return b.sysid < id; });
+        if (it != modified.end() && it->sysid == hypothetical.sysid) {
+            *it = hypothetical;
+        } else {
+            modified.insert(it, hypothetical);
+        }
+        CollisionDetector reference(config);
+        configure(reference);
+        reference.updateBoatStates(modified);
+        assertSameAlerts(detector.evaluateBoat(hypothetical.sysid, hypothetical),
+                         alertsForBoat(reference.detectCollisions(), hypothetical.sysid));
+    };
+    for (size_t k = 1; k < fleet.size(); k += 7) {
+        BoatState moved = fleet[k];
+        GeoPoint position = localToGeo(along(rng), lane_pick(rng) * 100.0 + 20.0);
+        moved.lat = position.lat;
+        moved.lng = position.lng;
+        moved.heading = 270.0;
+        moved.route_direction = RouteDirection::CLOCKWISE;
+        checkHypothetical(moved);
+        
+        BoatState undocking = createRouteBoat(fleet[k].sysid, -15.0, lane_pick(rng) * 100.0 + 10.0, 90.0, 2.0);
+        undocking.status = BoatStatus::UNDOCKING;
+        checkHypothetical(undocking);
+    }
+    
+    // 尚未加入船队的船只：插在已有船只之间或追加到末尾，在通道内或航线上
+    for (int sysid : {7, 401, 799, 9001}) {
+        checkHypothetical(createLaneBoat(sysid));
+        BoatState undocking = createRouteBoat(sysid, -15.0, 110.0, 90.0, 2.0);
+        undocking.status = BoatStatus::UNDOCKING;
+        checkHypothetical(undocking);
+    }
+    
+    // 查询不修改快照、航线索引与通道索引
+    assertSameAlerts(detector.detectCollisions(), full, 0.0);
+    
+    // 查询耗时只取决于邻近船只，不随航线索引重建增长
+    auto full_start = std::chrono::steady_clock::now();
+    detector.updateBoatStates(fleet);
+    detector.detectCollisions();
+    double full_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - full_start).count();
+    auto query_start = std::chrono::steady_clock::now();
+    const int queries = 400;
+    for (int k = 0; k < queries; ++k) {
+        detector.evaluateBoat(fleet[k % fleet.size()].sysid);
+    }
+    double query_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - query_start).count() / queries;
+    std::cout << "航线上单船查询平均耗时: " << query_us << " 微秒, 全量检测: " << full_us << " 微秒" << std::endl;
+    assert(query_us < full_us);
+    
+    std::cout << "航线上的单船准入查询测试通过!" << std::endl;
+}
+
+void testDeadlineDetection() {
+    std::cout << "测试限时检测..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    config.detection_threads = 1;
+    auto boats = createRandomFleet(2000, 99);
+    
+    CollisionDetector detector(config);
+    detector.updateBoatStates(boats);
+    auto full_start = std::chrono::steady_clock::now();
+    auto full = detector.detectCollisions();
+    double full_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - full_start).count();
+    
+    // 预算充足时与全量检测一致
+    auto complete = detector.detectCollisions(std::chrono::seconds(10));
+    DetectionStats complete_stats = detector.getLastStats();
+    assert(!complete_stats.budget_exhausted);
+    assert(complete_stats.deferred_pairs == 0);
+    assert(complete_stats.covered_horizon_s == config.warning_threshold_s);
+    assertSameAlerts(complete, full, 0.0);
+    
+    // 预算为零时只求解紧急类船对，所有紧急告警仍然完整
+    auto start = std::chrono::steady_clock::now();
+    auto partial = detector.detectCollisions(std::chrono::steady_clock::duration::zero());
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    DetectionStats stats = detector.getLastStats();
+    std::cout << "全量检测耗时: " << full_ms << " 毫秒, 零预算检测耗时: " << elapsed_ms
+              << " 毫秒, 求解船对: " << stats.solved_pairs
+              << ", 推迟船对: " << stats.deferred_pairs
+              << ", 完整覆盖碰撞时间: " << stats.covered_horizon_s << " 秒" << std::endl;
+    assert(stats.budget_exhausted);
+    assert(stats.deferred_pairs > 0);
+    assert(stats.covered_horizon_s >= config.emergency_threshold_s);
+    
+    // 预算用完后船对枚举只覆盖紧急距离，零预算检测快于全量检测
+    assert(elapsed_ms < full_ms);
+    
+    size_t emergencies = 0;
+    for (const auto& alert : full) {
+        if (alert.level != AlertLevel::EMERGENCY) continue;
+        ++emergencies;
+        bool found = false;
+        for (const auto& candidate : partial) {
+            if (candidate.current_boat_id == alert.current_boat_id && candidate.type == alert.type) {
+                assert(candidate.level == AlertLevel::EMERGENCY);
+                assert(candidate.collision_time == alert.collision_time);
+                found = true;
+            }
+        }
+        assert(found);
+    }
+    assert(emergencies > 0);
+    
+    // 多线程枚举与求解：预算充足时结果与全量检测一致
+    SystemConfig parallel_config = config;
+    parallel_config.detection_threads = 4;
+    CollisionDetector parallel(parallel_config);
+    parallel.updateBoatStates(boats);
+    assertSameAlerts(parallel.detectCollisions(std::chrono::seconds(10)), full, 0.0);
+    assert(!parallel.getLastStats().budget_exhausted);
+    assert(parallel.getLastStats().solved_pairs == complete_stats.solved_pairs);
+    
+    auto parallel_partial = parallel.detectCollisions(std::chrono::steady_clock::duration::zero());
+    assert(parallel.getLastStats().budget_exhausted);
+    for (const auto& alert : partial) {
+        if (alert.level != AlertLevel::EMERGENCY) continue;
+        bool found = false;
+        for (const auto& candidate : parallel_partial) {
+            found = found || (candidate.current_boat_id == alert.current_boat_id &&
+                              candidate.type == alert.type &&
+                              candidate.collision_time == alert.collision_time);
+        }
+        assert(found);
+    }
+    
+    std::cout << "限时检测测试通过!" << std::endl;
+}
+
+void testAdaptiveRecheck() {
+    std::cout << "测试自适应复查..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    config.detection_threads = 1;
+    auto boats = createRandomFleet(1000, 31);
+    
+    CollisionDetector adaptive(config);
+    adaptive.setAdaptiveRecheckEnabled(true);
+    CollisionDetector full(config);
+    
+    std::mt19937 rng(37);
+    std::uniform_int_distribution<size_t> pick(0, boats.size() - 1);
+    std::uniform_real_distribution<double> turn(60.0, 120.0);
+    double meters_per_deg_lat = geometry::EARTH_RADIUS * M_PI / 180.0;
+    double meters_per_deg_lng = meters_per_deg_lat * std::cos(geometry::toRadians(boats.front().lat));
+    
+    // 100毫秒一次检测，船只匀速航行8秒，每2秒有部分船只大角度转向
+    const int ticks = 80;
+    size_t adaptive_solved = 0, full_solved = 0, scheduled = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        if (tick > 0) {
+            for (auto& boat : boats) {
+                double heading_rad = geometry::toRadians(boat.heading);
+                boat.lat += boat.speed * std::cos(heading_rad) * 0.1 / meters_per_deg_lat;
+                boat.lng += boat.speed * std::sin(heading_rad) * 0.1 / meters_per_deg_lng;
+                boat.timestamp += 0.1;
+            }
+        }
+        if (tick > 0 && tick % 20 == 0) {
+            for (int k = 0; k < 50; ++k) {
+                BoatState& boat = boats[pick(rng)];
+                boat.heading = std::fmod(boat.heading + turn(rng), 360.0);
+            }
+        }
+        
+        adaptive.updateBoatStates(boats);
+        full.updateBoatStates(boats);
+        auto adaptive_alerts = adaptive.detectCollisions();
+        auto full_alerts = full.detectCollisions();
+        
+        // 跳过的船对在告警时域内不可能成为告警，结果与逐次全量求解一致
+        assertSameAlerts(adaptive_alerts, full_alerts, 0.0);
+        
+        const DetectionStats& stats = adaptive.getLastStats();
+        assert(stats.candidate_pairs == full.getLastStats().candidate_pairs);
+        adaptive_solved += stats.solved_pairs;
+        full_solved += full.getLastStats().solved_pairs;
+        scheduled += stats.scheduled_pairs;
+    }
+    std::cout << "每次检测平均求解船对: 自适应 " << adaptive_solved / ticks
+              << " / 全量 " << full_solved / ticks
+              << ", 平均按计划跳过: " << scheduled / ticks << std::endl;
+    assert(scheduled > 0);
+    assert(adaptive_solved + scheduled == full_solved);
+    
+    std::cout << "自适应复查测试通过!" << std::endl;
+}
+
+// 站点自定义规则示例：正常航行船只与航向交叉(既不同航线也非对向)的船只，按对向槽位告警
+struct CrossingRule {
+    template <typename View>
+    static bool applies(const View& view, size_t self, size_t other) {
+        return view.status(self) == BoatStatus::NORMAL_SAIL && !view.isOnSameRoute(self, other) &&
+               !view.isOncomingTraffic(self, other);
+    }
+    
+    template <typename Context>
+    static void classify(Context& context, size_t self, size_t other, double collision_time) {
+        using Slot = CollisionDetector::AlertSlot;
+        if (!context.record(Slot::ONCOMING, self, collision_time)) return;
+        context.updateLevel(Slot::ONCOMING, self, collision_time);
+        context.addOncomingBoat(Slot::ONCOMING, self, other);
+    }
+};
+
+using CrossingRules = rules::RulePipeline<rules::UndockingRule, rules::DockingRule,
+                                          rules::FollowingRule, rules::OncomingRule, CrossingRule>;
+
+void testRulePipeline() {
+    std::cout << "测试检测规则流水线..." << std::endl;
+    
+    SystemConfig config = SystemConfig::getDefault();
+    
+    // 两船在不同航线上垂直交叉，20秒后在(40, 0)相遇；默认规则不考虑交叉船只
+    BoatState east = createRouteBoat(1, 0.0, 0.0, 90.0, 2.0);
+    BoatState north = createRouteBoat(2, 40.0, -40.0, 0.0, 2.0);
+    north.route_direction = RouteDirection::COUNTERCLOCKWISE;
+    std::vector<BoatState> crossing = {east, north};
+    
+    CollisionDetector detector(config);
+    detector.updateBoatStates(crossing);
+    assert(detector.detectCollisions().empty());
+    
+    detector.setRules<CrossingRules>();
+    auto alerts = detector.detectCollisions();
+    assert(alerts.size() == 2);
+    for (const auto& alert : alerts) {
+        assert(alert.type == AlertType::ONCOMING);
+        assert(alert.level == AlertLevel::WARNING);
+        assert(alert.collision_time > 19.0 && alert.collision_time < 20.0);
+        assert(alert.oncoming_boat_ids.size() == 1);
+    }
+    
+    // 显式设置默认规则集与默认检测一致；附加规则不改变其余类型的告警
+    auto boats = createRandomFleet(2000, 71);
+    CollisionDetector baseline(config);
+    baseline.updateBoatStates(boats);
+    auto expected = baseline.detectCollisions();
+    
+    CollisionDetector explicit_default(config);
+    explicit_default.setRules<rules::DefaultRules>();
+    explicit_default.updateBoatStates(boats);
+    assertSameAlerts(explicit_default.detectCollisions(), expected, 0.0);
+    
+    CollisionDetector extended(config);
+    extended.setRules<CrossingRules>();
+    extended.updateBoatStates(boats);
+    auto extended_alerts = extended.detectCollisions();
+    std::vector<CollisionAlert> expected_primary, extended_primary;
+    for (const auto& alert : expected) {
+        if (alert.type != AlertType::ONCOMING) expected_primary.push_back(alert);
+    }
+    for (const auto& alert : extended_alerts) {
+        if (alert.type != AlertType::ONCOMING) extended_primary.push_back(alert);
+    }
+    assertSameAlerts(extended_primary, expected_primary, 0.0);
+    std::cout << "默认规则告警: " << expected.size() << ", 附加交叉规则后: "
+              << extended_alerts.size() << std::endl;
+    assert(extended_alerts.size() > expected.size());
+    
+    // 限时检测与动态检测按同一规则集实例归类
+    CollisionDetector budgeted(config);
+    budgeted.setRules<CrossingRules>();
+    budgeted.updateBoatStates(boats);
+    assertSameAlerts(budgeted.detectCollisions(std::chrono::seconds(60)), extended_alerts, 0.0);
+    
+    CollisionDetector kinetic(config);
+    kinetic.setRules<CrossingRules>();
+    kinetic.updateBoatStates(boats);
+    assertSameAlerts(kinetic.detectCollisionsAt(boats.front().timestamp), extended_alerts);
+    
+    std::cout << "检测规则流水线测试通过!" << std::endl;
+}
+
 int main() {
     std::cout << "开始运行测试..." << std::endl;
     
     try {
         testGeometryUtils();
+        testBatchGeometry();
+        testLocalProjector();
+        testFastTrig();
+        testPackedBoatState();
         testCollisionDetector();
+        testVectorizedCollisionKernel();
+        testBroadPhaseMatchesBruteForce();
+        testFusedPassMatchesReference();
+        testIncrementalDetection();
+        testParallelDetection();
+        testKineticDetection();
+        testRouteArcLengthIndex();
+        testRouteGeometry();
+        testHarborRTree();
+        testEvaluateBoat();
+        testAlertDeltas();
+        testAllocationFreeDetection();
+        testDockCorridorIndex();
+        testEvaluateBoatOnRoutes();
+        testDeadlineDetection();
+        testAdaptiveRecheck();
+        testRulePipeline();
         std::cout << "所有测试通过!" << std::endl;
     } catch (const std::exception& e) {
         std::cout << "测试失败: " << e.what() << std::endl;
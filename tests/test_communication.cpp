@@ -2,6 +2,8 @@
 #include "../src/udp_communicator.cpp"
 #include "../src/types.cpp"
 #include "../src/geometry_utils.cpp"
+#include "../src/local_projector.cpp"
+#include "../src/collision_kernel.cpp"
 #include <iostream>
 #include <cassert>
 #include <thread>
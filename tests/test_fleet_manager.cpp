@@ -0,0 +1,608 @@
+#include "../src/fleet_manager.cpp"
+#include "../src/boat_state_store.cpp"
+#include "../src/collision_detector.cpp"
+#include "../src/pair_cache.cpp"
+#include "../src/recheck_schedule.cpp"
+#include "../src/pair_priority_queue.cpp"
+#include "../src/kinetic_tracker.cpp"
+#include "../src/alert_table.cpp"
+#include "../src/types.cpp"
+#include "../src/geometry_utils.cpp"
+#include "../src/local_projector.cpp"
+#include "../src/spatial_hash_grid.cpp"
+#include "../src/boat_snapshot.cpp"
+#include "../src/collision_kernel.cpp"
+#include "../src/thread_pool.cpp"
+#include "../src/route_index.cpp"
+#include "../src/route_geometry.cpp"
+#include "../src/harbor_rtree.cpp"
+#include "../src/dock_corridor_index.cpp"
+#include "../src/region_partitioner.cpp"
+#include "../src/communication_protocol.cpp"
+#include "../src/udp_communicator.cpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace boat_pro;
+
+// 并发压力测试建议在ThreadSanitizer构建下运行：cmake -DBOAT_PRO_ENABLE_TSAN=ON
+
+BoatState createBoat(int sysid, double timestamp) {
+    BoatState boat;
+    boat.sysid = sysid;
+    boat.timestamp = timestamp;
+    boat.lat = 30.5490 + 0.00002 * (sysid % 10);
+    boat.lng = 114.3420 + 0.00002 * (sysid / 10);
+    boat.heading = (sysid % 2 == 0) ? 90.0 : 270.0;
+    boat.speed = 1.0 + 0.1 * (sysid % 5);
+    boat.status = BoatStatus::NORMAL_SAIL;
+    boat.route_direction = (sysid % 2 == 0) ? RouteDirection::CLOCKWISE
+                                            : RouteDirection::COUNTERCLOCKWISE;
+    return boat;
+}
+
+void testBoatStateStore() {
+    std::cout << "测试船只状态发布存储..." << std::endl;
+
+    BoatStateStore store;
+    assert(store.load()->boats.empty());
+
+    // 单条更新先暂存，flush()后才对读取方可见
+    store.update(createBoat(1, 1.0));
+    assert(store.load()->boats.empty());
+    assert(store.pendingCount() == 1);
+    assert(store.flush());
+    auto first = store.load();
+    assert(first->boats.size() == 1);
+    assert(!store.flush());
+    assert(store.load()->version == first->version);
+
+    // 已获取的快照不受后续发布影响；同一ID保留最后一条，一次flush只发布一个版本
+    store.update(createBoat(2, 2.0));
+    store.update(createBoat(1, 3.0));
+    store.update(createBoat(2, 5.0));
+    store.flush();
+    assert(first->boats.size() == 1);
+    assert(first->find(1)->timestamp == 1.0);
+
+    auto latest = store.load();
+    assert(latest->version == first->version + 1);
+    assert(latest->boats.size() == 2);
+    assert(latest->find(1)->timestamp == 3.0);
+    assert(latest->find(2)->timestamp == 5.0);
+
+    // 批量更新与暂存更新一起合并
+    store.update(createBoat(3, 6.0));
+    store.applyBatch({createBoat(4, 7.0), createBoat(2, 8.0)});
+    assert(store.pendingCount() == 0);
+    assert(store.load()->boats.size() == 4);
+    assert(store.load()->find(2)->timestamp == 8.0);
+    assert(store.load()->find(3)->timestamp == 6.0);
+
+    store.update(createBoat(9, 9.0));
+    store.replace({createBoat(5, 4.0)});
+    assert(store.pendingCount() == 0);
+    assert(store.load()->boats.size() == 1);
+    assert(store.load()->find(5) != nullptr);
+
+    // 大船队逐条接收：每条消息只暂存，每周期合并一次
+    BoatStateStore large;
+    std::vector<BoatState> fleet;
+    for (int id = 1; id <= 20000; ++id) fleet.push_back(createBoat(id, 0.0));
+    large.replace(fleet);
+    auto ingest_start = std::chrono::steady_clock::now();
+    for (int tick = 1; tick <= 5; ++tick) {
+        for (int id = 1; id <= 20000; ++id) large.update(createBoat(id, tick));
+        large.flush();
+    }
+    double ingest_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - ingest_start).count();
+    assert(large.load()->boats.size() == 20000);
+    assert(large.load()->find(777)->timestamp == 5.0);
+    std::cout << "20000船x5周期逐条更新耗时: " << ingest_ms << " ms" << std::endl;
+
+    std::cout << "船只状态发布存储测试通过!" << std::endl;
+}
+
+void testConcurrentSnapshotConsistency() {
+    std::cout << "测试并发发布快照一致性..." << std::endl;
+
+    const int boat_count = 40;
+    const int rounds = 300;
+    BoatStateStore store;
+    std::atomic<bool> writing(true);
+
+    // 写入方每轮整体替换船队，同一轮内所有船只时间戳相同
+    std::thread writer([&]() {
+        for (int round = 1; round <= rounds; ++round) {
+            std::vector<BoatState> boats;
+            for (int id = 1; id <= boat_count; ++id) {
+                boats.push_back(createBoat(id, round));
+            }
+            store.replace(boats);
+        }
+        writing = false;
+    });
+
+    // 读取方不能看到修改到一半的船队
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t last_version = 0;
+            while (writing) {
+                auto fleet = store.load();
+                assert(fleet->version >= last_version);
+                last_version = fleet->version;
+                if (fleet->boats.empty()) continue;
+
+                assert(static_cast<int>(fleet->boats.size()) == boat_count);
+                double timestamp = fleet->boats.front().timestamp;
+                for (const auto& boat : fleet->boats) {
+                    assert(boat.timestamp == timestamp);
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) reader.join();
+    assert(store.load()->boats.front().timestamp == rounds);
+
+    std::cout << "并发发布快照一致性测试通过!" << std::endl;
+}
+
+void testConcurrentIngestAndDetection() {
+    std::cout << "测试并发接入与检测..." << std::endl;
+
+    const int writer_count = 4;
+    const int boats_per_writer = 25;
+    const int updates_per_writer = 2000;
+
+    FleetManager manager;
+    std::atomic<size_t> callback_alerts(0);
+    manager.setAlertCallback([&](const CollisionAlert& alert) {
+        assert(alert.current_boat_id >= 1 && alert.current_boat_id <= writer_count * boats_per_writer);
+        ++callback_alerts;
+    });
+    manager.runSafetyMonitoring();
+
+    // 多个接入线程(模拟UDP/MQTT回调)各自更新一组船只
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writer_count; ++w) {
+        writers.emplace_back([&manager, w]() {
+            for (int k = 0; k < updates_per_writer; ++k) {
+                int sysid = w * boats_per_writer + k % boats_per_writer + 1;
+                BoatState boat = createBoat(sysid, k);
+                boat.heading = std::fmod(boat.heading + k, 360.0);
+                manager.updateBoatState(boat);
+            }
+        });
+    }
+
+    // 检测方、读取方与接入并发执行
+    std::atomic<bool> ingesting(true);
+    std::atomic<size_t> detections(0);
+    auto checkAlerts = [&](const std::vector<CollisionAlert>& alerts) {
+        for (const auto& alert : alerts) {
+            assert(alert.current_boat_id >= 1);
+            assert(alert.current_boat_id <= writer_count * boats_per_writer);
+        }
+    };
+    std::thread detector([&]() {
+        while (ingesting) {
+            checkAlerts(manager.detectNow());
+            ++detections;
+        }
+    });
+    std::thread reader([&]() {
+        while (ingesting) checkAlerts(manager.getCurrentAlerts());
+    });
+
+    for (auto& writer : writers) writer.join();
+    ingesting = false;
+    detector.join();
+    reader.join();
+    manager.stopSafetyMonitoring();
+
+    // 接入结束后检测看到完整船队
+    manager.runDetectionPass();
+    auto alerts = manager.getCurrentAlerts();
+    std::cout << "并发检测次数: " << detections << ", 最终告警数: " << alerts.size() << std::endl;
+    assert(detections > 0);
+
+    std::cout << "并发接入与检测测试通过!" << std::endl;
+}
+
+void testAlertDeltaCallback() {
+    std::cout << "测试告警变化回调..." << std::endl;
+
+    FleetManager manager;
+    std::vector<AlertDelta> deltas;
+    manager.setAlertDeltaCallback([&](const AlertDelta& delta) { deltas.push_back(delta); });
+
+    // 两船相向航行
+    BoatState east = createBoat(2, 1.0);
+    BoatState west = createBoat(3, 1.0);
+    west.lat = east.lat;
+    west.lng = east.lng + 0.0001;
+    manager.updateBoatStates({east, west});
+
+    // 读取告警表与立即检测都不执行告警表更新，不分发回调
+    assert(manager.getCurrentAlerts().empty());
+    auto immediate = manager.detectNow();
+    assert(!immediate.empty());
+    assert(manager.detectNow().size() == immediate.size());
+    assert(deltas.empty());
+
+    manager.runDetectionPass();
+    auto alerts = manager.getCurrentAlerts();
+    assert(alerts.size() == immediate.size());
+    assert(deltas.size() == alerts.size());
+    for (const auto& delta : deltas) {
+        assert(delta.event == AlertEvent::NEW);
+        assert(delta.alert.alert_id != 0);
+    }
+
+    // 重复读取告警表不产生变化，船队不变时再次检测也不产生变化
+    deltas.clear();
+    assert(manager.getCurrentAlerts().size() == alerts.size());
+    assert(manager.getCurrentAlerts().size() == alerts.size());
+    manager.runDetectionPass();
+    assert(manager.getCurrentAlerts().size() == alerts.size());
+    assert(deltas.empty());
+
+    // 两船远离后告警解除
+    west.lng = east.lng - 0.01;
+    manager.updateBoatStates({east, west});
+    assert(manager.detectNow().empty());
+    assert(deltas.empty());
+    manager.runDetectionPass();
+    assert(manager.getCurrentAlerts().empty());
+    assert(deltas.size() == alerts.size());
+    for (const auto& delta : deltas) {
+        assert(delta.event == AlertEvent::CLEARED);
+    }
+
+    std::cout << "告警变化回调测试通过!" << std::endl;
+}
+
+void assertSameShardedResult(const std::vector<CollisionAlert>& expected,
+                             const std::vector<CollisionAlert>& actual,
+                             const std::vector<AlertDelta>& single_deltas,
+                             const std::vector<AlertDelta>& sharded_deltas) {
+    assert(actual.size() == expected.size());
+    for (size_t k = 0; k < actual.size(); ++k) {
+        assert(actual[k].current_boat_id == expected[k].current_boat_id);
+        assert(actual[k].type == expected[k].type);
+        assert(actual[k].level == expected[k].level);
+        assert(actual[k].alert_id == expected[k].alert_id);
+        assert(actual[k].collision_time == expected[k].collision_time);
+        assert(actual[k].front_boat_ids == expected[k].front_boat_ids);
+        assert(actual[k].oncoming_boat_ids == expected[k].oncoming_boat_ids);
+    }
+    assert(sharded_deltas.size() == single_deltas.size());
+    for (size_t k = 0; k < sharded_deltas.size(); ++k) {
+        assert(sharded_deltas[k].event == single_deltas[k].event);
+        assert(sharded_deltas[k].previous_level == single_deltas[k].previous_level);
+        assert(sharded_deltas[k].alert.alert_id == single_deltas[k].alert.alert_id);
+        assert(sharded_deltas[k].alert.level == single_deltas[k].alert.level);
+    }
+}
+
+void testShardedDetection() {
+    std::cout << "测试地理分片检测..." << std::endl;
+
+    // 八个港区沿经度方向相距约2公里，每个港区400条船
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> offset(0.0, 0.004);
+    std::uniform_real_distribution<double> heading(0.0, 360.0);
+    std::uniform_real_distribution<double> speed(0.0, 4.0);
+    std::uniform_int_distribution<int> status(1, 3);
+    std::vector<BoatState> boats;
+    for (int harbor = 0; harbor < 8; ++harbor) {
+        for (int k = 0; k < 400; ++k) {
+            BoatState boat = createBoat(static_cast<int>(boats.size()) + 1, 0.0);
+            boat.lat = 30.546 + offset(rng);
+            boat.lng = 114.339 + 0.025 * harbor + offset(rng);
+            boat.heading = heading(rng);
+            boat.speed = speed(rng);
+            boat.status = static_cast<BoatStatus>(status(rng));
+            boats.push_back(boat);
+        }
+    }
+
+    SystemConfig config = SystemConfig::getDefault();
+    config.detection_threads = 1;
+    FleetManager single(config);
+    config.detection_shards = 4;
+    FleetManager sharded(config);
+
+    std::vector<AlertDelta> single_deltas, sharded_deltas;
+    single.setAlertDeltaCallback([&](const AlertDelta& delta) { single_deltas.push_back(delta); });
+    sharded.setAlertDeltaCallback([&](const AlertDelta& delta) { sharded_deltas.push_back(delta); });
+
+    double meters_per_deg = geometry::EARTH_RADIUS * M_PI / 180.0;
+    double single_ms = 0.0, sharded_ms = 0.0;
+    size_t alert_count = 0, delta_count = 0;
+    for (int tick = 0; tick < 12; ++tick) {
+        // 船只匀速航行，跨越分片边界；中途部分船只离开船队
+        if (tick > 0) {
+            for (auto& boat : boats) {
+                double heading_rad = geometry::toRadians(boat.heading);
+                boat.lat += boat.speed * std::cos(heading_rad) * 2.0 / meters_per_deg;
+                boat.lng += boat.speed * std::sin(heading_rad) * 2.0 /
+                            (meters_per_deg * std::cos(geometry::toRadians(boat.lat)));
+                boat.timestamp += 2.0;
+            }
+        }
+        if (tick == 6) boats.resize(boats.size() - 300);
+        single.updateBoatStates(boats);
+        sharded.updateBoatStates(boats);
+
+        single_deltas.clear();
+        sharded_deltas.clear();
+        auto start = std::chrono::steady_clock::now();
+        single.runDetectionPass();
+        auto middle = std::chrono::steady_clock::now();
+        sharded.runDetectionPass();
+        auto end = std::chrono::steady_clock::now();
+        auto expected = single.getCurrentAlerts();
+        auto actual = sharded.getCurrentAlerts();
+        single_ms += std::chrono::duration<double, std::milli>(middle - start).count();
+        sharded_ms += std::chrono::duration<double, std::milli>(end - middle).count();
+
+        // 合并结果与单一检测器一致，包括告警ID与变化事件
+        assertSameShardedResult(expected, actual, single_deltas, sharded_deltas);
+        alert_count += actual.size();
+        delta_count += sharded_deltas.size();
+    }
+    unsigned hardware_threads = std::thread::hardware_concurrency();
+    std::cout << "累计告警: " << alert_count << ", 告警变化: " << delta_count
+              << ", 单一检测器耗时: " << single_ms << " 毫秒, 4分片耗时: " << sharded_ms
+              << " 毫秒(硬件线程数 " << hardware_threads << ")" << std::endl;
+    assert(alert_count > 0 && delta_count > 0);
+    
+    // 加速比只在硬件线程数不少于分片数时有意义
+    if (hardware_threads >= 4) {
+        assert(sharded_ms < single_ms);
+    } else {
+        std::cout << "硬件线程数少于分片数，未检查分片加速比" << std::endl;
+    }
+
+    std::cout << "地理分片检测测试通过!" << std::endl;
+}
+
+// 以(lat0, lng0)为原点的局部平面坐标(米)转换为经纬度
+GeoPoint localToGeo(double x, double y) {
+    const double lat0 = 30.5490;
+    const double lng0 = 114.3420;
+    double meters_per_deg_lat = geometry::EARTH_RADIUS * M_PI / 180.0;
+    return GeoPoint(lat0 + y / meters_per_deg_lat,
+                    lng0 + x / (meters_per_deg_lat * std::cos(geometry::toRadians(lat0))));
+}
+
+void testShardedHairpinRoute() {
+    std::cout << "测试折返航线上的分片检测..." << std::endl;
+
+    // 折返航线：沿y=0向东4公里，在东端折返后沿y=1向西。去程末船的弧长前船在东端折返处，
+    // 空间上最近的却是回程中弧长更远的船只
+    RouteInfo hairpin;
+    hairpin.route_id = 1;
+    hairpin.direction = RouteDirection::CLOCKWISE;
+    for (int k = 0; k <= 40; ++k) hairpin.points.push_back(localToGeo(k * 100.0, 0.0));
+    for (int k = 40; k >= 0; --k) hairpin.points.push_back(localToGeo(k * 100.0, 1.0));
+
+    auto createRouteBoat = [](int sysid, double x, double y, double heading, double speed) {
+        BoatState boat = createBoat(sysid, 0.0);
+        GeoPoint position = localToGeo(x, y);
+        boat.lat = position.lat;
+        boat.lng = position.lng;
+        boat.heading = heading;
+        boat.speed = speed;
+        boat.route_direction = RouteDirection::CLOCKWISE;
+        return boat;
+    };
+
+    std::vector<BoatState> boats;
+    int sysid = 1;
+    // 航线北侧的静止船只铺满整个港区，使分片沿东西方向划分
+    for (double x = 0.0; x <= 4000.0; x += 25.0) {
+        boats.push_back(createRouteBoat(sysid++, x, 300.0, 90.0, 0.0));
+    }
+    // 去程与回程船只两两相向交会：同一航线、同一航线方向，不是对向交通
+    std::mt19937 rng(37);
+    std::uniform_real_distribution<double> along(200.0, 3000.0), gap(8.0, 20.0);
+    for (int k = 0; k < 40; ++k) {
+        double x = along(rng);
+        boats.push_back(createRouteBoat(sysid++, x, 0.0, 90.0, 1.0));
+        boats.push_back(createRouteBoat(sysid++, x + gap(rng), 1.0, 270.0, 1.0));
+    }
+    // 去程后段的跟随船对：后船追赶慢速前船，产生跟随告警
+    for (int k = 0; k < 8; ++k) {
+        double x = 3100.0 + k * 100.0;
+        boats.push_back(createRouteBoat(sysid++, x, 0.0, 90.0, 1.0));
+        boats.push_back(createRouteBoat(sysid++, x + 10.0, 0.0, 90.0, 0.5));
+    }
+    // 刚驶过折返点的船只：去程末船的弧长前船
+    boats.push_back(createRouteBoat(sysid++, 3990.0, 1.0, 270.0, 1.0));
+
+    SystemConfig config = SystemConfig::getDefault();
+    config.detection_threads = 1;
+    FleetManager single(config);
+    config.detection_shards = 4;
+    FleetManager sharded(config);
+    single.initializeRoutes({hairpin});
+    sharded.initializeRoutes({hairpin});
+
+    std::vector<AlertDelta> single_deltas, sharded_deltas;
+    single.setAlertDeltaCallback([&](const AlertDelta& delta) { single_deltas.push_back(delta); });
+    sharded.setAlertDeltaCallback([&](const AlertDelta& delta) { sharded_deltas.push_back(delta); });
+
+    size_t alert_count = 0;
+    for (int tick = 0; tick < 4; ++tick) {
+        for (auto& boat : boats) {
+            double heading_rad = geometry::toRadians(boat.heading);
+            double meters_per_deg = geometry::EARTH_RADIUS * M_PI / 180.0;
+            boat.lat += boat.speed * std::cos(heading_rad) * 2.0 / meters_per_deg;
+            boat.lng += boat.speed * std::sin(heading_rad) * 2.0 /
+                        (meters_per_deg * std::cos(geometry::toRadians(boat.lat)));
+            boat.timestamp += 2.0;
+        }
+        single.updateBoatStates(boats);
+        sharded.updateBoatStates(boats);
+
+        single_deltas.clear();
+        sharded_deltas.clear();
+        single.runDetectionPass();
+        sharded.runDetectionPass();
+        auto expected = single.getCurrentAlerts();
+        assertSameShardedResult(expected, sharded.getCurrentAlerts(), single_deltas, sharded_deltas);
+        alert_count += expected.size();
+    }
+    std::cout << "折返航线累计告警: " << alert_count << std::endl;
+    assert(alert_count > 0);
+
+    std::cout << "折返航线上的分片检测测试通过!" << std::endl;
+}
+
+void testShardScaling() {
+    std::cout << "测试分片数与检测加速比..." << std::endl;
+
+    // 八个港区沿东西方向相距2公里，一条航线贯穿各港区；每个港区300条散布船只、
+    // 100条沿航线航行的船只
+    RouteInfo route;
+    route.route_id = 1;
+    route.direction = RouteDirection::CLOCKWISE;
+    for (int k = 0; k <= 160; ++k) route.points.push_back(localToGeo(k * 100.0, 0.0));
+
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> offset(0.0, 400.0), heading(0.0, 360.0), speed(0.0, 4.0);
+    std::vector<BoatState> boats;
+    for (int harbor = 0; harbor < 8; ++harbor) {
+        double base = harbor * 2000.0;
+        for (int k = 0; k < 400; ++k) {
+            bool on_route = k < 100;
+            GeoPoint position = localToGeo(base + offset(rng), on_route ? 0.0 : offset(rng) + 20.0);
+            BoatState boat = createBoat(static_cast<int>(boats.size()) + 1, 0.0);
+            boat.lat = position.lat;
+            boat.lng = position.lng;
+            boat.heading = on_route ? 90.0 : heading(rng);
+            boat.speed = speed(rng);
+            boat.route_direction = RouteDirection::CLOCKWISE;
+            boats.push_back(boat);
+        }
+    }
+
+    // 各分片数使用硬件并发数的线程；1分片即单一检测器
+    const std::vector<int> shard_counts = {1, 2, 4, 8};
+    std::vector<std::unique_ptr<FleetManager>> managers;
+    std::vector<std::vector<AlertDelta>> deltas(shard_counts.size());
+    for (size_t m = 0; m < shard_counts.size(); ++m) {
+        SystemConfig config = SystemConfig::getDefault();
+        config.detection_threads = 0;
+        config.detection_shards = shard_counts[m];
+        managers.push_back(std::make_unique<FleetManager>(config));
+        managers[m]->initializeRoutes({route});
+        managers[m]->setAlertDeltaCallback([&deltas, m](const AlertDelta& delta) {
+            deltas[m].push_back(delta);
+        });
+    }
+
+    double meters_per_deg = geometry::EARTH_RADIUS * M_PI / 180.0;
+    std::vector<double> elapsed_ms(shard_counts.size(), 0.0);
+    for (int tick = 0; tick < 8; ++tick) {
+        for (auto& boat : boats) {
+            double heading_rad = geometry::toRadians(boat.heading);
+            boat.lat += boat.speed * std::cos(heading_rad) * 2.0 / meters_per_deg;
+            boat.lng += boat.speed * std::sin(heading_rad) * 2.0 /
+                        (meters_per_deg * std::cos(geometry::toRadians(boat.lat)));
+            boat.timestamp += 2.0;
+        }
+        for (size_t m = 0; m < managers.size(); ++m) {
+            managers[m]->updateBoatStates(boats);
+            deltas[m].clear();
+            auto start = std::chrono::steady_clock::now();
+            managers[m]->runDetectionPass();
+            elapsed_ms[m] += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        auto expected = managers[0]->getCurrentAlerts();
+        for (size_t m = 1; m < managers.size(); ++m) {
+            assertSameShardedResult(expected, managers[m]->getCurrentAlerts(), deltas[0], deltas[m]);
+        }
+    }
+
+    std::cout << "硬件线程数 " << std::thread::hardware_concurrency() << std::endl;
+    for (size_t m = 0; m < shard_counts.size(); ++m) {
+        std::cout << "分片数 " << shard_counts[m] << ": 耗时 " << elapsed_ms[m]
+                  << " 毫秒, 加速比 " << elapsed_ms[0] / elapsed_ms[m] << std::endl;
+    }
+
+    std::cout << "分片数与检测加速比测试通过!" << std::endl;
+}
+
+void testRecommendedDock() {
+    std::cout << "测试推荐船坞..." << std::endl;
+
+    // 三个船坞沿东西方向相距500米
+    std::vector<DockInfo> docks;
+    for (int d = 0; d < 3; ++d) {
+        GeoPoint position = localToGeo(d * 500.0, 0.0);
+        docks.push_back({101 + d, position.lat, position.lng});
+    }
+
+    for (bool fast_trig : {false, true}) {
+        SystemConfig config = SystemConfig::getDefault();
+        config.fast_trig = fast_trig;
+        FleetManager manager(config);
+        assert(manager.getRecommendedDock(1) == -1);
+        manager.initializeDocks(docks);
+
+        // 尚无船只状态时返回第一个船坞
+        assert(manager.getRecommendedDock(1) == 101);
+
+        // 单条更新无需等待检测周期即按最新位置推荐
+        BoatState boat = createBoat(1, 0.0);
+        GeoPoint position = localToGeo(980.0, 60.0);
+        boat.lat = position.lat;
+        boat.lng = position.lng;
+        manager.updateBoatState(boat);
+        assert(manager.getRecommendedDock(1) == 103);
+
+        position = localToGeo(560.0, -40.0);
+        boat.lat = position.lat;
+        boat.lng = position.lng;
+        boat.timestamp = 1.0;
+        manager.updateBoatState(boat);
+        assert(manager.getRecommendedDock(1) == 102);
+    }
+
+    std::cout << "推荐船坞测试通过!" << std::endl;
+}
+
+int main() {
+    std::cout << "开始运行船队管理测试..." << std::endl;
+
+    try {
+        testBoatStateStore();
+        testConcurrentSnapshotConsistency();
+        testConcurrentIngestAndDetection();
+        testAlertDeltaCallback();
+        testShardedDetection();
+        testShardedHairpinRoute();
+        testShardScaling();
+        testRecommendedDock();
+        std::cout << "所有测试通过!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "测试失败: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}